@@ -1,68 +1,80 @@
 /*
- * barrier.c contains functions for sending and handling barrier check requests.
+ * barrier.c contains functions for keeping track of barrier tags and sending and handling barrier check requests.
  */
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "barrier.h"
 #include "entity/all.h"
 #include "entity/array.h"
 #include "entity/id.h"
-#include "entity/root.h"
-#include "util/array.h"
-#include "util/type.h"
+#include "error.h"
 
-// Barrier carrier definition
-// Provides info about entities that carry barrier tags
+// Barrier tag info
 typedef struct{
-	EntId id;
-	size_t btag_offset;
-} BarrierTagCarrierDef;
+	// # of carriers with the tag that haven't been destroyed
+	int carriers;
 
-static BarrierTagCarrierDef g_btc_list[] = {
-	{ENT_ID_GROUNDGUY, offsetof(EntGROUNDGUY, btag)},
-	{ENT_ID_SLIDEGUY, offsetof(EntSLIDEGUY, btag)},
-};
+	// Handles to the first and last barriers with the tag
+	// Each barrier has a handle to the next one
+	EntHandle first;
+	EntHandle last;
 
-// Barrier check request stack
-#define	BARRIER_CHECK_REQUEST_STACK_LEN	20
+	// True if a check request for the tag is waiting to be handled
+	bool requested;
+} BarrierTagInfo;
+
+// Info for each tag, indexed by the tag as an unsigned byte
+static BarrierTagInfo g_btag_info[BARRIER_TAG_MAX];
 
+// Barrier check request stack
+// Tags are only added once at a time, so it can hold a request for every tag
 static struct{
-	BarrierTag stack[BARRIER_CHECK_REQUEST_STACK_LEN];
+	BarrierTag stack[BARRIER_TAG_MAX];
 	int len;
 } g_bcr_stack;
 
-// Sends a barrier check request
-// Returns nonzero on error
-bool barrier_send_check_request(BarrierTag btag)
-{
-	if (btag == 0)
-	{
-		PINF("btag 0 check request sent. ignoring.");
-		return 1;
-	}
-	if (g_bcr_stack.len >= BARRIER_CHECK_REQUEST_STACK_LEN)
-	{
-		PERR("max barrier check requests sent. ignoring current request.");
-		return 1;
-	}
+// Returns the info of a tag
+static BarrierTagInfo *barrier_tag_info(BarrierTag btag);
 
-	// Check if the tag was already added to the stack
-	for (int i = 0; i < g_bcr_stack.len; ++i)
-	{
-		if (g_bcr_stack.stack[i] == btag)
-		{
-			// Tag was already added to the stack
-			return 1;
-		}
+// Adds a carrier to the count of live carriers of a tag
+// This should be called when a carrier is created
+void barrier_add_carrier(BarrierTag btag)
+{
+	if (btag != 0)
+		barrier_tag_info(btag)->carriers++;
+}
 
-	}
+// Removes a carrier from the count of live carriers of a tag, sending a check request for the tag if it was the last one
+// This should be called when a carrier is destroyed
+void barrier_remove_carrier(BarrierTag btag)
+{
+	if (btag == 0)
+		return;
 
-	// Add the tag to the stack
+	BarrierTagInfo *info = barrier_tag_info(btag);
+	if (--info->carriers > 0 || info->requested)
+		return;
+	info->requested = true;
 	g_bcr_stack.stack[g_bcr_stack.len++] = btag;
+}
 
-	return 0;
+// Adds a barrier to the list of barriers of a tag
+// next is the barrier's handle to the next barrier in the list
+void barrier_add_barrier(BarrierTag btag, EntHandle h, EntHandle *next)
+{
+	BarrierTagInfo *info = barrier_tag_info(btag);
+	*next = ENT_HANDLE_NONE;
+
+	// Barriers are added to the end so they're opened in the order they were created
+	EntBARRIER *last = ent_handle_get(ENT_ID_BARRIER, info->last);
+	if (last == NULL)
+		info->first = h;
+	else
+		last->next = h;
+	info->last = h;
 }
 
 // Handles check requests
@@ -73,49 +85,35 @@ void barrier_handle_check_requests(void)
 	{
 		// Current btag being checked
 		BarrierTag btag = g_bcr_stack.stack[i];
-
-		bool btag_should_clean = true;
-
-		// Loop through entities that could have a matching btag
-		for (int j = 0; j < (int) ARR_LEN(g_btc_list); ++j)
-		{
-			BarrierTagCarrierDef *d = &g_btc_list[j];
-
-			// Loop through entity array
-			EntArray *ea = g_er[d->id];
-			Byte *e = (Byte *) ea->e + d->btag_offset;
-
-			for (int k = 0; k < ea->len; ++k)
-			{
-				if (* (BarrierTag *) e == btag)
-				{
-					// Entity has matching btag, don't clean
-					btag_should_clean = false;
-					goto l_ent_loop_exit;
-				}
-				e += ea->ent_size;
-			}
-		}
-
-	l_ent_loop_exit:
-		// Clean the btag if necessary
-		if (btag_should_clean)
-		{
-			PINF("cleaning barrier tag %d", btag);
-
-			EntBARRIER *e = g_er[ENT_ID_BARRIER]->e;
-			for (int i = 0; i < g_er[ENT_ID_BARRIER]->len; ++i)
-			{
-				if (e->btag == btag)
-					ent_destroy_BARRIER(e);
-				++e;
-			}
-		}
-
-		// Delete entities marked for deletion
-		ent_array_clean(g_er[ENT_ID_BARRIER]);
+		BarrierTagInfo *info = barrier_tag_info(btag);
+		info->requested = false;
+
+		// A carrier with the tag could have been created after the request was sent
+		if (info->carriers > 0)
+			continue;
+
+		PINF("cleaning barrier tag %d", btag);
+		EntBARRIER *e;
+		for (EntHandle h = info->first; (e = ent_handle_get(ENT_ID_BARRIER, h)) != NULL; h = e->next)
+			ent_destroy_BARRIER(e);
+		info->first = info->last = ENT_HANDLE_NONE;
 	}
 
 	// Finished looping through requests, reset request stack
 	g_bcr_stack.len = 0;
 }
+
+// Forgets all carriers, barriers and check requests
+// This should be called whenever carrier and barrier entity arrays are reset
+void barrier_reset(void)
+{
+	for (int i = 0; i < BARRIER_TAG_MAX; i++)
+		g_btag_info[i] = (BarrierTagInfo) {0, ENT_HANDLE_NONE, ENT_HANDLE_NONE, false};
+	g_bcr_stack.len = 0;
+}
+
+// Returns the info of a tag
+static BarrierTagInfo *barrier_tag_info(BarrierTag btag)
+{
+	return &g_btag_info[(uint8_t) btag];
+}
@@ -1,5 +1,7 @@
 /*
- * barrier.h contains the barrier tag type and functions for sending and handling barrier check requests.
+ * barrier.h contains the barrier tag type and functions for keeping track of barrier tags and sending and handling barrier check requests.
+ *
+ * Barriers are opened once every carrier (an entity that carries a barrier tag) with the same tag has been destroyed. Each tag keeps a count of its live carriers and a list of its barriers, so checking a tag doesn't have to look through any entity arrays. A check request is sent when the last carrier of a tag is destroyed, and requests are handled at the end of every tick, which destroys the barriers of each requested tag that still has no carriers.
  */
 
 #ifndef	BARRIER_H
@@ -8,16 +10,32 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "entity/array.h"	// For EntHandle
 #include "entity/id.h"
 #include "void_rect.h"
 
 typedef VoidRectInt BarrierTag;
 
-// Sends a barrier check request
-// Returns nonzero on error
-bool barrier_send_check_request(BarrierTag btag);
+// # of different barrier tags
+#define	BARRIER_TAG_MAX	256
+
+// Adds a carrier to the count of live carriers of a tag
+// This should be called when a carrier is created
+void barrier_add_carrier(BarrierTag btag);
+
+// Removes a carrier from the count of live carriers of a tag, sending a check request for the tag if it was the last one
+// This should be called when a carrier is destroyed
+void barrier_remove_carrier(BarrierTag btag);
+
+// Adds a barrier to the list of barriers of a tag
+// next is the barrier's handle to the next barrier in the list
+void barrier_add_barrier(BarrierTag btag, EntHandle h, EntHandle *next);
 
 // Handles check requests
 void barrier_handle_check_requests(void);
 
+// Forgets all carriers, barriers and check requests
+// This should be called whenever carrier and barrier entity arrays are reset
+void barrier_reset(void);
+
 #endif
@@ -0,0 +1,357 @@
+/*
+ * bench.c contains functions for benchmarking the game's simulation without a window, renderer or audio device.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <SDL2/SDL.h>
+
+#include "bench.h"
+#include "camera.h"
+#include "entity/all.h"
+#include "entity/c_body.h"
+#include "error.h"
+#include "genmap.h"
+#include "init.h"
+#include "map.h"
+#include "particle.h"
+#include "replay.h"
+#include "sim.h"
+#include "tile/data.h"
+#include "trace.h"
+
+// Timing results of a benchmark, measured in performance counter ticks
+typedef struct{
+	// # of frames simulated
+	int frames;
+
+	// Total, shortest and longest time taken to update a frame
+	uint64_t total;
+	uint64_t min;
+	uint64_t max;
+} BenchStats;
+
+// A map in the benchmark suite
+typedef struct{
+	// Path of the map file that's generated for the benchmark
+	char *path;
+
+	// Parameters the map is generated with
+	GenMapParams params;
+} BenchSuiteMap;
+
+// Maps in the benchmark suite, from smallest to largest followed by ones with more entities
+// Entity densities shrink as maps grow so that entity counts stay comparable between maps
+static const BenchSuiteMap g_bench_suite[] = {
+	{"bench_100.map",  {.width = 100,  .height = 100,  .seed = 1, .solid = 0.15, .spike = 0.02, .turret = 0.001,    .groundguy = 0.005,   .coin = 0.02,   .void_rects = 4}},
+	{"bench_500.map",  {.width = 500,  .height = 500,  .seed = 1, .solid = 0.15, .spike = 0.02, .turret = 0.0002,   .groundguy = 0.0006,  .coin = 0.01,   .void_rects = 8}},
+	{"bench_1000.map", {.width = 1000, .height = 1000, .seed = 1, .solid = 0.15, .spike = 0.02, .turret = 0.00005,  .groundguy = 0.00015, .coin = 0.004,  .void_rects = 12}},
+	{"bench_2000.map", {.width = 2000, .height = 2000, .seed = 1, .solid = 0.15, .spike = 0.02, .turret = 0.00001,  .groundguy = 0.00004, .coin = 0.001,  .void_rects = 20}},
+	{"bench_ents.map", {.width = 200,  .height = 200,  .seed = 1, .solid = 0.10, .spike = 0.01, .turret = 0.001,    .groundguy = 0.004,   .coin = 0.1,    .void_rects = 8}},
+};
+
+// Size of a cache line in bytes, used to show how many entities each cache line read by an update loop holds
+#define	BENCH_CACHE_LINE	64
+
+// Name of the entity layout that the game was built with
+#ifdef	ENT_COMPACT
+	#define	BENCH_LAYOUT	"compact"
+#else
+	#define	BENCH_LAYOUT	"default"
+#endif
+
+// Name and size of a struct shown by --sizes
+typedef struct{
+	const char *name;
+	size_t size;
+} BenchSize;
+
+#define	BENCH_SIZE_ENT(name)	{#name, sizeof(Ent##name)}
+
+// Structs shown by --sizes, components followed by entity types in the order of their ids
+static const BenchSize g_bench_size[] = {
+	{"EcmBase", sizeof(EcmBase)},
+	{"EcmBody", sizeof(EcmBody)},
+	{"EcmEgg", sizeof(EcmEgg)},
+	BENCH_SIZE_ENT(ITEM),
+	BENCH_SIZE_ENT(FIREBALL),
+	BENCH_SIZE_ENT(RAGDOLL),
+	BENCH_SIZE_ENT(GROUNDGUY),
+	BENCH_SIZE_ENT(CLOUD),
+	BENCH_SIZE_ENT(SLIDEGUY),
+	BENCH_SIZE_ENT(EVILBALL),
+	BENCH_SIZE_ENT(TURRET),
+	BENCH_SIZE_ENT(DOOR),
+	BENCH_SIZE_ENT(SAVEBIRD),
+	BENCH_SIZE_ENT(BARRIER),
+	BENCH_SIZE_ENT(COOLEGG),
+};
+
+// Resets the timing results in *stats
+static void bench_stats_reset(BenchStats *stats);
+
+// Simulates one frame of the current map and adds its timing to *stats
+static void bench_frame(BenchStats *stats);
+
+// Prints the results of a benchmark
+static void bench_print(const char *name, uint64_t load_ticks, const BenchStats *stats);
+
+// Converts performance counter ticks to milliseconds
+static double bench_ticks_to_ms(uint64_t ticks);
+
+// Moves the camera to where it is on the benchmark suite's camera path on frame frame out of frames
+static void bench_cam_path(int frame, int frames);
+
+// Returns the # of bytes used by the current map, the entity arrays, particles and bodies
+static size_t bench_mem_size(void);
+
+// Runs a benchmark using the command line arguments that follow "--bench"
+// Returns nonzero on error
+int bench_main(int argc, char **argv)
+{
+	if (argc < 1 || argc > 2)
+	{
+		PERR("usage: --bench <map> [frames]");
+		return 1;
+	}
+
+	int frames = BENCH_FRAMES_DEFAULT;
+	if (argc == 2 && (frames = atoi(argv[1])) <= 0)
+	{
+		PERR("invalid frame count \"%s\"", argv[1]);
+		return 1;
+	}
+
+	if (game_init_headless())
+		return 1;
+
+	uint64_t load_start = SDL_GetPerformanceCounter();
+	if (TRACE_INT("map_load", map_load(argv[0], false)))
+	{
+		game_quit_headless();
+		return 1;
+	}
+	uint64_t load_ticks = SDL_GetPerformanceCounter() - load_start;
+
+	// Spawn clouds just like the game does when it starts
+	ent_cloud_update_count();
+
+	BenchStats stats;
+	bench_stats_reset(&stats);
+	while (stats.frames < frames)
+		bench_frame(&stats);
+	bench_print(argv[0], load_ticks, &stats);
+
+	game_quit_headless();
+	return 0;
+}
+
+// Plays back a replay using the command line arguments that follow "--replay"
+// Returns nonzero on error or if the replay didn't reach the same game state as its recording
+int bench_replay_main(int argc, char **argv)
+{
+	if (argc != 1)
+	{
+		PERR("usage: --replay <file>");
+		return 1;
+	}
+
+	if (game_init_headless())
+		return 1;
+
+	uint64_t load_start = SDL_GetPerformanceCounter();
+	if (replay_play_start(argv[0]))
+	{
+		game_quit_headless();
+		return 1;
+	}
+	uint64_t load_ticks = SDL_GetPerformanceCounter() - load_start;
+
+	BenchStats stats;
+	bench_stats_reset(&stats);
+	while (replay_frames_left())
+		bench_frame(&stats);
+	bench_print(argv[0], load_ticks, &stats);
+
+	int desynced = replay_stop();
+	if (!desynced)
+		printf("replay:         reached the recorded game state\n");
+
+	game_quit_headless();
+	return desynced;
+}
+
+// Runs the benchmark suite using the command line arguments that follow "--bench-suite"
+// Returns nonzero on error
+int bench_suite_main(int argc, char **argv)
+{
+	if (argc > 1)
+	{
+		PERR("usage: --bench-suite [frames]");
+		return 1;
+	}
+
+	int frames = BENCH_FRAMES_DEFAULT;
+	if (argc == 1 && (frames = atoi(argv[0])) <= 0)
+	{
+		PERR("invalid frame count \"%s\"", argv[0]);
+		return 1;
+	}
+
+	if (game_init_headless())
+		return 1;
+	printf("entity layout:  %s\n\n", BENCH_LAYOUT);
+
+	const int maps = sizeof(g_bench_suite) / sizeof(g_bench_suite[0]);
+	uint64_t load_ticks[maps];
+	size_t mem[maps];
+	BenchStats stats[maps];
+	int err = 0;
+	for (int i = 0; i < maps; i++)
+	{
+		const BenchSuiteMap *m = &g_bench_suite[i];
+		if (genmap_write(m->path, &m->params))
+		{
+			err = 1;
+			break;
+		}
+
+		uint64_t load_start = SDL_GetPerformanceCounter();
+		if (TRACE_INT("map_load", map_load(m->path, false)))
+		{
+			err = 1;
+			break;
+		}
+		load_ticks[i] = SDL_GetPerformanceCounter() - load_start;
+		mem[i] = bench_mem_size();
+		ent_cloud_update_count();
+
+		// The camera follows its path instead of the player, so the player is kept dead
+		g_player.hp = 0;
+
+		bench_stats_reset(&stats[i]);
+		while (stats[i].frames < frames)
+		{
+			bench_cam_path(stats[i].frames, frames);
+			bench_frame(&stats[i]);
+		}
+		bench_print(m->path, load_ticks[i], &stats[i]);
+		printf("memory:         %zu KiB\n\n", mem[i] / 1024);
+	}
+
+	if (!err)
+	{
+		printf("%-16s %11s %10s %10s %10s %10s\n", "map", "size", "load ms", "mem KiB", "avg ms", "max ms");
+		for (int i = 0; i < maps; i++)
+		{
+			char size[16];
+			snprintf(size, sizeof(size), "%dx%d", g_bench_suite[i].params.width, g_bench_suite[i].params.height);
+			printf("%-16s %11s %10.3f %10zu %10.4f %10.4f\n",
+				g_bench_suite[i].path,
+				size,
+				bench_ticks_to_ms(load_ticks[i]),
+				mem[i] / 1024,
+				bench_ticks_to_ms(stats[i].total) / stats[i].frames,
+				bench_ticks_to_ms(stats[i].max)
+			);
+		}
+	}
+
+	game_quit_headless();
+	return err;
+}
+
+// Prints the size of every entity type using the command line arguments that follow "--sizes"
+// Returns nonzero on error
+int bench_sizes_main(int argc, char **argv)
+{
+	if (argc != 0)
+	{
+		PERR("usage: --sizes");
+		return 1;
+	}
+
+	printf("entity layout:  %s\n", BENCH_LAYOUT);
+	printf("%-12s %8s %10s %12s\n", "struct", "bytes", "per line", "chunk bytes");
+	for (size_t i = 0; i < sizeof(g_bench_size) / sizeof(g_bench_size[0]); i++)
+	{
+		const BenchSize *s = &g_bench_size[i];
+		printf("%-12s %8zu %10.2f %12zu\n", s->name, s->size, (double) BENCH_CACHE_LINE / s->size, s->size * ENT_CHUNK_LEN);
+	}
+	return 0;
+}
+
+// Resets the timing results in *stats
+static void bench_stats_reset(BenchStats *stats)
+{
+	*stats = (BenchStats) {
+		.frames = 0,
+		.total = 0,
+		.min = UINT64_MAX,
+		.max = 0,
+	};
+}
+
+// Simulates one frame of the current map and adds its timing to *stats
+static void bench_frame(BenchStats *stats)
+{
+	uint64_t start = SDL_GetPerformanceCounter();
+	sim_update();
+	uint64_t ticks = SDL_GetPerformanceCounter() - start;
+
+	stats->frames++;
+	stats->total += ticks;
+	if (ticks < stats->min)
+		stats->min = ticks;
+	if (ticks > stats->max)
+		stats->max = ticks;
+}
+
+// Prints the results of a benchmark
+static void bench_print(const char *name, uint64_t load_ticks, const BenchStats *stats)
+{
+	double total_ms = bench_ticks_to_ms(stats->total);
+
+	if (stats->frames == 0)
+	{
+		printf("no frames were simulated\n");
+		return;
+	}
+
+	printf("run:            %s\n", name);
+	printf("load time:      %.3f ms\n", bench_ticks_to_ms(load_ticks));
+	printf("frames:         %d\n", stats->frames);
+	printf("simulated fps:  %.1f\n", total_ms > 0.0 ? stats->frames * 1000.0 / total_ms : 0.0);
+	printf("update time:    min %.4f ms, avg %.4f ms, max %.4f ms\n",
+		bench_ticks_to_ms(stats->min),
+		total_ms / stats->frames,
+		bench_ticks_to_ms(stats->max)
+	);
+}
+
+// Converts performance counter ticks to milliseconds
+static double bench_ticks_to_ms(uint64_t ticks)
+{
+	return ticks * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+// Moves the camera to where it is on the benchmark suite's camera path on frame frame out of frames
+static void bench_cam_path(int frame, int frames)
+{
+	// The camera sweeps a figure eight that covers most of the map once per run
+	const double t = 2.0 * M_PI * frame / frames;
+	g_cam.x = g_map.width * TILE_SIZE * (0.5 + 0.4 * sin(t));
+	g_cam.y = g_map.height * TILE_SIZE * (0.5 + 0.4 * sin(2.0 * t));
+}
+
+// Returns the # of bytes used by the current map, the entity arrays and particles
+static size_t bench_mem_size(void)
+{
+	size_t size = map_mem_size();
+	for (int i = 1; i < ENT_MAX; i++)
+		size += ent_array_mem_size(g_er[i]);
+	return size + ptcl_mem_size() + ecm_body_mem_size();
+}
@@ -0,0 +1,41 @@
+/*
+ * bench.h contains functions for benchmarking the game's simulation without a window, renderer or audio device.
+ *
+ * A benchmark loads a map, updates the game world through sim_update() for a number of frames, and reports how many frames could be simulated per second along with the min/avg/max time taken to update a frame. Nothing is drawn, so the results show only the cost of the simulation.
+ *
+ * Benchmarks are started from the command line:
+ * 	soupdl --bench <map> [frames]
+ *
+ * The benchmark suite generates a fixed set of maps (see genmap.h) that grow in size and entity count, then benchmarks each of them while the camera moves along a scripted path instead of following the player. It prints a table of load times, memory use and update times, to show how they scale:
+ * 	soupdl --bench-suite [frames]
+ *
+ * The size of every entity type in the entity layout the game was built with (see c_base.h) can be printed along with how many of each type fit in a cache line, to compare the default and compact layouts:
+ * 	soupdl --sizes
+ *
+ * Replays (see replay.h) can also be played back as benchmarks, which makes it possible to compare builds using the exact same play session:
+ * 	soupdl --replay <file>
+ */
+
+#ifndef	BENCH_H
+#define	BENCH_H
+
+// The number of frames simulated when no frame count is given
+#define	BENCH_FRAMES_DEFAULT	600
+
+// Runs a benchmark using the command line arguments that follow "--bench"
+// Returns nonzero on error
+int bench_main(int argc, char **argv);
+
+// Runs the benchmark suite using the command line arguments that follow "--bench-suite"
+// Returns nonzero on error
+int bench_suite_main(int argc, char **argv);
+
+// Plays back a replay using the command line arguments that follow "--replay"
+// Returns nonzero on error or if the replay didn't reach the same game state as its recording
+int bench_replay_main(int argc, char **argv);
+
+// Prints the size of every entity type using the command line arguments that follow "--sizes"
+// Returns nonzero on error
+int bench_sizes_main(int argc, char **argv);
+
+#endif
@@ -20,6 +20,8 @@
 GameCamera g_cam = {
 	.x = 0,
 	.y = 0,
+	.xprev = 0,
+	.yprev = 0,
 	.xshift = 0,
 	.yshift = 0,
 	.scroll_stop = false,
@@ -27,17 +29,33 @@ GameCamera g_cam = {
 	.ystop = false
 };
 
-// Updates the camera's xshift and yshift based on its position & x/y stop
-void cam_update_shifts(void)
+// Sets the camera's xshift and yshift for the camera being at (x, y)
+static void cam_set_shifts(int x, int y);
+
+// Sets the camera's xshift and yshift for the camera being at (x, y)
+static void cam_set_shifts(int x, int y)
 {
 	if (g_cam.xstop)
-		g_cam.xshift = clamp(-g_cam.x + g_screen_width / 2, -g_map.width * TILE_SIZE + g_screen_width, 0);
+		g_cam.xshift = clamp(-x + g_screen_width / 2, -g_map.width * TILE_SIZE + g_screen_width, 0);
 	else
-		g_cam.xshift = -g_cam.x + g_screen_width / 2;
+		g_cam.xshift = -x + g_screen_width / 2;
 	if (g_cam.ystop)
-		g_cam.yshift = clamp(-g_cam.y + g_screen_height / 2, -g_map.height * TILE_SIZE + g_screen_height, 0);
+		g_cam.yshift = clamp(-y + g_screen_height / 2, -g_map.height * TILE_SIZE + g_screen_height, 0);
 	else
-		g_cam.yshift = -g_cam.y + g_screen_height / 2;
+		g_cam.yshift = -y + g_screen_height / 2;
+}
+
+// Updates the camera's xshift and yshift based on its position & x/y stop
+void cam_update_shifts(void)
+{
+	cam_set_shifts(g_cam.x, g_cam.y);
+}
+
+// Updates the camera's xshift and yshift based on its position interpolated between the previous and current simulation ticks
+// This should be called before drawing
+void cam_lerp_shifts(void)
+{
+	cam_set_shifts(TS_LERP(g_cam.xprev, g_cam.x), TS_LERP(g_cam.yprev, g_cam.y));
 }
 
 // Updates the camera's xstop and ystop based on the screen dimensions
@@ -98,3 +116,11 @@ bool cam_can_see_point(int x, int y, int leeway)
 	const int ydist_max = g_screen_height / 2 + leeway;
 	return xdist <= xdist_max && ydist <= ydist_max;
 }
+
+// Returns true if any part of rectangle rect in the game world is within leeway pixels of the screen, using the shifts that things are drawn with
+bool cam_can_see_rect(const SDL_Rect *rect, int leeway)
+{
+	const int x = rect->x + g_cam.xshift;
+	const int y = rect->y + g_cam.yshift;
+	return x < g_screen_width + leeway && x + rect->w > -leeway && y < g_screen_height + leeway && y + rect->h > -leeway;
+}
@@ -7,11 +7,17 @@
 
 #include <stdbool.h>
 
+#include <SDL2/SDL.h>
+
 typedef struct{
 	// Position
 	int x;
 	int y;
 
+	// Position on the previous simulation tick
+	int xprev;
+	int yprev;
+
 	// Number of pixels to shift anything drawn on the screen by horizontally
 	int xshift;
 
@@ -37,6 +43,10 @@ void cam_update_limits(void);
 // Updates the camera's xshift and yshift based on its position & x/y stop
 void cam_update_shifts(void);
 
+// Updates the camera's xshift and yshift based on its position interpolated between the previous and current simulation ticks
+// This should be called before drawing
+void cam_lerp_shifts(void);
+
 // Uses arrow keys to move the camera
 void cam_update_position(void);
 
@@ -46,4 +56,7 @@ void cam_get_tile_dimensions(int *left, int *right, int *top, int *bottom);
 // Returns true if the camera can see point (x, y) in the game world
 bool cam_can_see_point(int x, int y, int leeway);
 
+// Returns true if any part of rectangle rect in the game world is within leeway pixels of the screen, using the shifts that things are drawn with
+bool cam_can_see_rect(const SDL_Rect *rect, int leeway);
+
 #endif
@@ -6,7 +6,7 @@
 
 #include <stdlib.h>	// For free()
 
-#include "map.h"	// For MAP_PATH_MAX and map_free()
+#include "map.h"	// For MAP_PATH_MAX and map_grid_free()
 #include "collector.h"
 
 // Global collector map data list
@@ -56,7 +56,7 @@ void col_free(void)
 	for (int i = 0; i < g_col.len; ++i)
 	{
 		free(g_col.data[i].path);
-		map_free(g_col.data[i].height, g_col.data[i].map);
+		map_grid_free(&g_col.data[i].map);
 	}
 	g_col.len = 0;
 }
@@ -20,6 +20,7 @@
 #include <stdint.h>
 
 #include "entity/tile.h"	// For EntTileId
+#include "map.h"		// For MapGrid
 
 // Maximum number of maps to remember
 #define	COL_MAP_MAX	100
@@ -37,7 +38,7 @@ typedef struct{
 	int width, height;
 
 	// Map data of entity tile ids
-	EntTileId **map;
+	MapGrid map;
 } ColMapData;
 
 typedef struct{
@@ -2,18 +2,35 @@
  * collision.c contains functions for handling collisions between different things in the game world.
  */
 
+#include <limits.h>
 #include <stdbool.h>
 
 #include <SDL2/SDL.h>
 
 #include "collision.h"
 #include "tile/data.h"	
+#include "tile/plane.h"
 #include "map.h"
+#include "timestep.h"
 
 #include "entity/item.h"	
 #include "entity/fireball.h"	
 #include "entity/evilball.h"
-#include "entity/root.h"
+#include "entity/grid.h"
+
+// Returned by check_tile_row_find() when no tile is found
+#define	CHECK_TILE_NONE	INT_MIN
+
+// Passed as the flags to check_tile_row_find() to look for tiles by id instead
+#define	CHECK_TILE_ID	0
+
+// Returns the tile row or column that a pixel position is in, rounding down for positions left of or above the map
+static inline int check_tile_div(int pos);
+
+// Finds the first tile from column tx1 to column tx2 (in either direction) in row ty that has one of the flags passed, or has the id passed if flags is CHECK_TILE_ID
+// Tiles outside of the map are g_tile_outside
+// Returns the column of the tile and stores its id in *id if id isn't NULL, or returns CHECK_TILE_NONE if there isn't one
+static int check_tile_row_find(int ty, int tx1, int tx2, TileFlags flags, TileId find_id, TileId *id);
 
 // Returns true if there is a collision between two rectangles
 bool check_rect(const SDL_Rect *r1, const SDL_Rect *r2)
@@ -33,113 +50,232 @@ TileId check_tile_point(const int x, const int y)
 		)
 		return g_tile_outside;
 	
-	return g_tile_map[cy][cx];
+	return map_grid_get(&g_tile_map, cx, cy);
+}
+
+// Returns true if the tile at an x and y position in the world has one of the flags passed
+bool check_tile_point_flags(const int x, const int y, const TileFlags flags)
+{
+	return check_tile_row_find(check_tile_div(y), check_tile_div(x), check_tile_div(x), flags, 0, NULL) != CHECK_TILE_NONE;
 }
 
 /*
  * This function returns true if a tile with the id passed to it collides with a rectangle.
  *
- * NOTE: This function only checks the four corners of the rectangles passed. This means that it may not return accurate values if the rectangle has a width or height that is greater than or equal to TILE_SIZE (defined in tile/data.h)
+ * Like all tile collision functions, this treats the rectangle as covering pixels x to x + w and y to y + h, and checks every tile it covers.
  */
 bool check_tile_rect_id(const SDL_Rect *rect, const TileId id)
 {
-	// Top left corner
-	if (check_tile_point(rect->x, rect->y) == id)
-		return true;
-
-	// Top right corner
-	if (check_tile_point(rect->x + rect->w, rect->y) == id)
-		return true;
-
-	// Bottom left corner
-	if (check_tile_point(rect->x, rect->y + rect->h) == id)
-		return true;
-
-	// Bottom right corner
-	if (check_tile_point(rect->x + rect->w, rect->y + rect->h) == id)
-		return true;
-	
+	const int ty2 = check_tile_div(rect->y + rect->h);
+	for (int ty = check_tile_div(rect->y); ty <= ty2; ty++)
+		if (check_tile_row_find(ty, check_tile_div(rect->x), check_tile_div(rect->x + rect->w), CHECK_TILE_ID, id, NULL) != CHECK_TILE_NONE)
+			return true;
 	return false;
 }
 
 /*
  * This function returns the tile id of a tile that a rectangle collides with. The tile found must have the same flags as the flags passed to the function. If no desired tiles are found, TILE_AIR (zero) is returned.
  *
- * NOTE: This function only checks the four corners of the rectangles passed. This means that it may not return accurate values if the rectangle has a width or height that is greater than or equal to TILE_SIZE (defined in tile/data.h)
+ * Like all tile collision functions, this treats the rectangle as covering pixels x to x + w and y to y + h, and checks every tile it covers.
  */
 TileId check_tile_rect_flags(const SDL_Rect *rect, const TileFlags flags)
 {
 	TileId id;
+	const int ty2 = check_tile_div(rect->y + rect->h);
+	for (int ty = check_tile_div(rect->y); ty <= ty2; ty++)
+		if (check_tile_row_find(ty, check_tile_div(rect->x), check_tile_div(rect->x + rect->w), flags, 0, &id) != CHECK_TILE_NONE)
+			return id;
+	return TILE_AIR;
+}
 
-	// Top left corner
-	if (g_tile_md[(id = check_tile_point(rect->x, rect->y))].flags & flags)
+// Returns the id of the first tile with one of the flags passed in the row of pixels at y from x1 to x2, or TILE_AIR if there isn't one
+TileId check_tile_row_flags(const int y, const int x1, const int x2, const TileFlags flags)
+{
+	TileId id;
+	if (check_tile_row_find(check_tile_div(y), check_tile_div(x1), check_tile_div(x2), flags, 0, &id) != CHECK_TILE_NONE)
 		return id;
+	return TILE_AIR;
+}
 
-	// Top right corner
-	if (g_tile_md[(id = check_tile_point(rect->x + rect->w, rect->y))].flags & flags)
-		return id;
+// Moves a rectangle horizontally by dx pixels and finds the first tile with one of the flags passed that it runs into
+bool check_tile_sweep_x(const SDL_Rect *rect, const int dx, const TileFlags flags, TileHit *hit)
+{
+	if (dx == 0)
+		return false;
 
-	// Bottom left corner
-	if (g_tile_md[(id = check_tile_point(rect->x, rect->y + rect->h))].flags & flags)
-		return id;
+	// Columns from the one the leading edge is in to the one it would end up in
+	const int edge = dx > 0 ? rect->x + rect->w : rect->x;
+	const int tx1 = check_tile_div(edge);
+	const int tx2 = check_tile_div(edge + dx);
 
-	// Bottom right corner
-	if (g_tile_md[(id = check_tile_point(rect->x + rect->w, rect->y + rect->h))].flags & flags)
-		return id;
-	
-	return TILE_AIR;
+	// Find the closest column with a tile in any row the rectangle covers
+	int tx_hit = CHECK_TILE_NONE;
+	TileId id = TILE_AIR;
+	const int ty2 = check_tile_div(rect->y + rect->h);
+	for (int ty = check_tile_div(rect->y); ty <= ty2; ty++)
+	{
+		// Columns past the closest one found so far don't need to be checked
+		TileId row_id;
+		const int tx = check_tile_row_find(ty, tx1, tx_hit == CHECK_TILE_NONE ? tx2 : tx_hit, flags, 0, &row_id);
+		if (tx != CHECK_TILE_NONE && (tx_hit == CHECK_TILE_NONE || tx != tx_hit))
+		{
+			tx_hit = tx;
+			id = row_id;
+		}
+	}
+	if (tx_hit == CHECK_TILE_NONE)
+		return false;
+
+	hit->pos = dx > 0 ? tx_hit * TILE_SIZE - rect->w - 1 : (tx_hit + 1) * TILE_SIZE;
+	hit->id = id;
+	return true;
 }
 
-// Returns a pointer to an entity if the rectangle rect instersects with one, otherwise NULL is returned
-EntITEM *check_ent_item(const SDL_Rect *rect)
+// Moves a rectangle vertically by dy pixels and finds the first tile with one of the flags passed that it runs into
+bool check_tile_sweep_y(const SDL_Rect *rect, const int dy, const TileFlags flags, TileHit *hit)
 {
-	// Item rectangle
-	SDL_Rect irect = {.w = 16, .h = 16};
+	if (dy == 0)
+		return false;
+
+	// Rows from the one the leading edge is in to the one it would end up in
+	const int edge = dy > 0 ? rect->y + rect->h : rect->y;
+	const int ty1 = check_tile_div(edge);
+	const int ty2 = check_tile_div(edge + dy);
+	const int step = dy > 0 ? 1 : -1;
+
+	// The first row with a tile in the columns the rectangle covers is the closest one
+	const int tx1 = check_tile_div(rect->x);
+	const int tx2 = check_tile_div(rect->x + rect->w);
+	for (int ty = ty1; ty != ty2 + step; ty += step)
+	{
+		TileId id;
+		if (check_tile_row_find(ty, tx1, tx2, flags, 0, &id) == CHECK_TILE_NONE)
+			continue;
 
-	EntITEM *item = g_er[ENT_ID_ITEM]->e;
-	for (int i = 0; i < g_er[ENT_ID_ITEM]->len; i++)
+		hit->pos = dy > 0 ? ty * TILE_SIZE - rect->h - 1 : (ty + 1) * TILE_SIZE;
+		hit->id = id;
+		return true;
+	}
+	return false;
+}
+
+/*
+ * This function finds the # of ticks until something at (x, y) that moves hsp and vsp pixels every tick (multiplied by g_ts) will be in a tile with one of the flags passed. Its position is checked after every tick the same way entity updates check their positions, but the tile map is only read when it moves into a different tile.
+ *
+ * Returns the # of ticks (at least 1) if it's in a tile within ticks_max ticks, 0 if it isn't, or -1 if it never will be because it left the map and is moving away from it.
+ */
+int check_tile_ray(float x, float y, float hsp, float vsp, const TileFlags flags, const int ticks_max)
+{
+	int tx_last = INT_MIN;
+	int ty_last = INT_MIN;
+	for (int i = 1; i <= ticks_max; i++)
 	{
-		irect.x = item->x - 8;
-		irect.y = item->y - 8;
-		if (check_rect(&irect, rect))
-			return item;
-		item++;
+		// Move exactly like the entity would, so the same positions are checked
+		x += hsp * g_ts;
+		y += vsp * g_ts;
+
+		const int tx = check_tile_div((int) x);
+		const int ty = check_tile_div((int) y);
+		if (tx == tx_last && ty == ty_last)
+			continue;
+		tx_last = tx;
+		ty_last = ty;
+
+		if (check_tile_row_find(ty, tx, tx, flags, 0, NULL) != CHECK_TILE_NONE)
+			return i;
+
+		// Past the edge of the map, every tile it can reach is an outside tile, which didn't match
+		if ((tx < 0 && hsp <= 0.0f) || (tx >= g_map.width && hsp >= 0.0f) || (ty < 0 && vsp <= 0.0f) || (ty >= g_map.height && vsp >= 0.0f))
+			return -1;
 	}
-	return NULL;
+	return 0;
 }
 
 // Returns a pointer to an entity if the rectangle rect instersects with one, otherwise NULL is returned
-EntFIREBALL *check_ent_fireball(const SDL_Rect *rect)
+EntITEM *check_ent_item(const SDL_Rect *rect)
 {
-	// Fireball rectangle
-	SDL_Rect frect = {.w = 16, .h = 16};
+	return ent_grid_first(ENT_ID_ITEM, rect);
+}
 
-	EntFIREBALL *fireball = g_er[ENT_ID_FIREBALL]->e;
-	for (int i = 0; i < g_er[ENT_ID_FIREBALL]->len; i++)
-	{
-		frect.x = fireball->x - 8;
-		frect.y = fireball->y - 8;
-		if (check_rect(&frect, rect) && fireball->base.status != ENT_STAT_DEL)
-			return fireball;
-		fireball++;
-	}
-	return NULL;
+// Returns a pointer to an entity if the rectangle rect instersects with one, otherwise NULL is returned
+EntFIREBALL *check_ent_fireball(const SDL_Rect *rect)
+{
+	return ent_grid_first(ENT_ID_FIREBALL, rect);
 }
 
 // Returns a pointer to an entity if the rectangle rect instersects with one, otherwise NULL is returned
 EntEVILBALL *check_ent_evilball(const SDL_Rect *rect)
 {
-	// Evilball rectangle
-	SDL_Rect crect = {.w = 16, .h = 16};
+	return ent_grid_first(ENT_ID_EVILBALL, rect);
+}
+
+// Returns the tile row or column that a pixel position is in, rounding down for positions left of or above the map
+static inline int check_tile_div(int pos)
+{
+	return pos >= 0 ? pos / TILE_SIZE : (pos + 1) / TILE_SIZE - 1;
+}
+
+// Finds the first tile from column tx1 to column tx2 (in either direction) in row ty that has one of the flags passed, or has the id passed if flags is CHECK_TILE_ID
+// Tiles outside of the map are g_tile_outside
+// Returns the column of the tile and stores its id in *id if id isn't NULL, or returns CHECK_TILE_NONE if there isn't one
+static int check_tile_row_find(int ty, int tx1, int tx2, TileFlags flags, TileId find_id, TileId *id)
+{
+	const int step = tx2 >= tx1 ? 1 : -1;
+	const bool outside_match = flags == CHECK_TILE_ID ? g_tile_outside == find_id : (g_tile_md[g_tile_outside].flags & flags) != 0;
+
+	// Columns of the span that are in the map, from the first one checked to the last one
+	int in1 = tx1 < 0 ? 0 : tx1 >= g_map.width ? g_map.width - 1 : tx1;
+	int in2 = tx2 < 0 ? 0 : tx2 >= g_map.width ? g_map.width - 1 : tx2;
+	const bool in_map = ty >= 0 && ty < g_map.height && (step == 1 ? tx1 < g_map.width && tx2 >= 0 : tx1 >= 0 && tx2 < g_map.width);
+
+	// The first column checked is outside of the map
+	if (!in_map || tx1 != in1)
+	{
+		if (!outside_match)
+		{
+			if (!in_map)
+				return CHECK_TILE_NONE;
+		}
+		else
+		{
+			if (id != NULL)
+				*id = g_tile_outside;
+			return tx1;
+		}
+	}
+
+	const int plane = flags == CHECK_TILE_ID ? -1 : tile_plane_of(flags);
+	if (plane != -1)
+	{
+		// Check the whole span a word at a time
+		const int tx = tile_plane_find(plane, ty, in1, in2);
+		if (tx != TILE_PLANE_NONE)
+		{
+			if (id != NULL)
+				*id = map_grid_get(&g_tile_map, tx, ty);
+			return tx;
+		}
+	}
+	else
+	{
+		for (int tx = in1; tx != in2 + step; tx += step)
+		{
+			const TileId tile = map_grid_get(&g_tile_map, tx, ty);
+			if (flags == CHECK_TILE_ID ? tile == find_id : (g_tile_md[tile].flags & flags) != 0)
+			{
+				if (id != NULL)
+					*id = tile;
+				return tx;
+			}
+		}
+	}
 
-	EntEVILBALL *e = g_er[ENT_ID_EVILBALL]->e;
-	for (int i = 0; i < g_er[ENT_ID_EVILBALL]->len; i++)
+	// The span goes past the far edge of the map
+	if (outside_match && tx2 != in2)
 	{
-		crect.x = e->x - 8;
-		crect.y = e->y - 8;
-		if (check_rect(&crect, rect))
-			return e;
-		e++;
+		if (id != NULL)
+			*id = g_tile_outside;
+		return in2 + step;
 	}
-	return NULL;
+	return CHECK_TILE_NONE;
 }
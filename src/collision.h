@@ -23,22 +23,54 @@ bool check_rect(const SDL_Rect *r1, const SDL_Rect *r2);
 // Returns the tile id of the tile at an x and y position in the tile map
 TileId check_tile_point(const int x, const int y);
 
+// Returns true if the tile at an x and y position in the world has one of the flags passed
+bool check_tile_point_flags(const int x, const int y, const TileFlags flags);
+
 /*
  * This function returns true if a tile with the id passed to it collides with a rectangle.
  *
- * NOTE: This function only checks the four corners of the rectangles passed. This means that it may not return accurate values if the rectangle has a width or height that is greater than or equal to TILE_SIZE (defined in tile/data.h)
+ * Like all tile collision functions, this treats the rectangle as covering pixels x to x + w and y to y + h, and checks every tile it covers.
  */
 bool check_tile_rect_id(const SDL_Rect *rect, const TileId id);
 
 /*
  * This function returns the tile id of a tile that a rectangle collides with. The tile found must have the same flags as the flags passed to the function. If no desired tiles are found, TILE_AIR (zero) is returned.
  *
- * NOTE: This function only checks the four corners of the rectangles passed. This means that it may not return accurate values if the rectangle has a width or height that is greater than or equal to TILE_SIZE (defined in tile/data.h)
+ * Like all tile collision functions, this treats the rectangle as covering pixels x to x + w and y to y + h, and checks every tile it covers.
  */
 TileId check_tile_rect_flags(const SDL_Rect *rect, const TileFlags flags);
 
+// Returns the id of the first tile with one of the flags passed in the row of pixels at y from x1 to x2, or TILE_AIR if there isn't one
+TileId check_tile_row_flags(const int y, const int x1, const int x2, const TileFlags flags);
+
+// Result of sweeping a rectangle through the tile map
+typedef struct{
+	// Position on the axis of the move that the rectangle stops at while touching the tile
+	int pos;
+
+	// Id of the tile touched
+	TileId id;
+} TileHit;
+
+/*
+ * These functions move a rectangle by dx or dy pixels along one axis and find the first tile with one of the flags passed that it runs into. Every tile between the rectangle's leading edge and where it would end up is checked, so fast rectangles can't pass through thin walls. Tiles are read a row at a time straight from the tile map.
+ *
+ * If a tile is found, true is returned and *hit is filled in. Tiles that the leading edge of the rectangle is already inside of count as being run into, so a rectangle stuck in a tile is pushed back out of it.
+ */
+bool check_tile_sweep_x(const SDL_Rect *rect, const int dx, const TileFlags flags, TileHit *hit);
+bool check_tile_sweep_y(const SDL_Rect *rect, const int dy, const TileFlags flags, TileHit *hit);
+
+/*
+ * This function finds the # of ticks until something at (x, y) that moves hsp and vsp pixels every tick (multiplied by g_ts) will be in a tile with one of the flags passed. Its position is checked after every tick the same way entity updates check their positions, but the tile map is only read when it moves into a different tile.
+ *
+ * Returns the # of ticks (at least 1) if it's in a tile within ticks_max ticks, 0 if it isn't, or -1 if it never will be because it left the map and is moving away from it.
+ */
+int check_tile_ray(float x, float y, float hsp, float vsp, const TileFlags flags, const int ticks_max);
+
 // These functions return pointers to entities that intersect with the rectangle rect
+// If more than one entity intersects with it, the first one in its entity array is returned
 // If no collision occurs, they return NULL
+// Entities are found with their type's grid (see entity/grid.h)
 EntITEM *check_ent_item(const SDL_Rect *rect);
 EntFIREBALL *check_ent_fireball(const SDL_Rect *rect);
 EntEVILBALL *check_ent_evilball(const SDL_Rect *rect);
@@ -59,14 +59,14 @@ static void maped_draw_entmap(void)
 	{
 		for (int x = tile_left; x < tile_right; x++)
 		{
-			EntTile et = g_ent_map[y][x];
+			EntTileId etid = map_grid_get(&g_ent_map, x, y);
 
-			// Don't draw inactive tiles
-			if (!et.active)
+			// Don't draw empty tiles
+			if (etid == ENT_TILE_NONE)
 				continue;
 
 			// Getting tile texture
-			EntTileTex *tt = &g_ent_tile[et.etid].tex;
+			EntTileTex *tt = &g_ent_tile[etid].tex;
 			
 			// Drawing red box around tile
 			SDL_Rect drect = {x * TILE_SIZE + g_cam.xshift, y * TILE_SIZE + g_cam.yshift, TILE_SIZE, TILE_SIZE};
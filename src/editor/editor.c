@@ -15,9 +15,11 @@
 #include "../input.h"		// For spdl_input_string()
 #include "../util/math.h"	// For MIN
 #include "../tile/data.h"	// For room dimensions, TileId, and TILE_SIZE
+#include "../tile/plane.h"	// For tile_set()
 #include "../entity/door.h"	// For ENT_DOOR_MAX and g_ent_door_map_path
 #include "../entity/tile.h"
-#include "../map.h"		// For map_alloc and map_free
+#include "../map.h"		// For MapGrid
+#include "../trace.h"
 #include "../util/string.h"
 #include "editor.h"
 #include "draw.h"
@@ -25,8 +27,8 @@
 // When asked for general string input, this is the max length of the string received
 #define	INPUT_STR_LEN	20
 
-// Pointer to 2d array containing entity tiles
-EntTile **g_ent_map = NULL;
+// Entity tile ids of the map, only allocated while editing
+MapGrid g_ent_map = {.chunk = NULL};
 
 // Converts *x and *y from mouse coordinates on the window to tile coordinates
 // If *x is set to -1, the mouse coordinates are out of bounds
@@ -46,15 +48,12 @@ static inline void maped_pick_ent(MapEd *ed, int num);
 // This should be called whenever the map editor loop is about to start
 int maped_init(void)
 {
-	if (g_ent_map != NULL)
+	if (g_ent_map.chunk != NULL)
 		return 0;
 
 	// Allocate mem for entity map
-	if ((g_ent_map = map_alloc(g_map.width, g_map.height, sizeof(EntTile))) == NULL)
-	{
-		PERR("failed to allocate mem for entity map");
+	if (map_grid_alloc(&g_ent_map, g_map.width, g_map.height, ENT_TILE_NONE))
 		return 1;
-	}
 
 	// Success
 	return 0;
@@ -72,17 +71,17 @@ int maped_resize_map(int width_inc, int height_inc)
 	g_map.height += height_inc;
 
 	// Automatically update camera limits to reflect
-	TileId **temp_tile_map;
-	EntTile **temp_ent_map;
-	if ((temp_tile_map = map_alloc(g_map.width, g_map.height, sizeof(TileId))) == NULL)
+	MapGrid temp_tile_map;
+	MapGrid temp_ent_map;
+	if (map_grid_alloc(&temp_tile_map, g_map.width, g_map.height, TILE_AIR))
 	{
 		PERR("failed to allocate temporary tile map");
 		return 1;
 	}
-	if ((temp_ent_map = map_alloc(g_map.width, g_map.height, sizeof(EntTile))) == NULL)
+	if (map_grid_alloc(&temp_ent_map, g_map.width, g_map.height, ENT_TILE_NONE))
 	{
 		PERR("failed to allocate temporary entity map");
-		map_free(g_map.height, temp_tile_map);
+		map_grid_free(&temp_tile_map);
 		return 1;
 	}
 
@@ -97,36 +96,31 @@ int maped_resize_map(int width_inc, int height_inc)
 	else
 		height_max = g_map.height;
 
-	// Copy map data into temp maps (TODO: use memcpy for this)
+	// Copy map data into temp maps
+	// Newly added tiles are left empty
 	for (int y = 0; y < height_max; ++y)
 	{
 		for (int x = 0; x < width_max; ++x)
 		{
-			temp_tile_map[y][x] = g_tile_map[y][x];
-			temp_ent_map[y][x] = g_ent_map[y][x];
+			if (
+				map_grid_set(&temp_tile_map, x, y, map_grid_get(&g_tile_map, x, y)) ||
+				map_grid_set(&temp_ent_map, x, y, map_grid_get(&g_ent_map, x, y))
+				)
+			{
+				map_grid_free(&temp_tile_map);
+				map_grid_free(&temp_ent_map);
+				return 1;
+			}
 		}
 	}
 
-	// Set newly allocated tiles to default values
-	#define	SET_DEFAULT_TILE()	{ \
-						temp_tile_map[y][x] = TILE_AIR; \
-						temp_ent_map[y][x] = (EntTile) {.active = false}; \
-					}
-
-	for (int y = 0; y < g_map.height; y++)
-		for (int x = width_max; x < g_map.width; x++)
-			SET_DEFAULT_TILE();
-	for (int y = height_max; y < g_map.height; y++)
-		for (int x = 0; x < g_map.width; x++)
-			SET_DEFAULT_TILE();
-
 	// Free old map data
-	map_free(g_map.height - height_inc, g_tile_map);
-	map_free(g_map.height - height_inc, g_ent_map);
+	map_grid_free(&g_tile_map);
+	map_grid_free(&g_ent_map);
 
 	g_tile_map = temp_tile_map;
 	g_ent_map = temp_ent_map;
-	return 0;
+	return tile_plane_build();
 }
 
 // Handles SDL keydown events
@@ -172,20 +166,24 @@ void maped_handle_keydown(MapEd *ed, SDL_Keycode key)
 	// Resize map
 	case SDLK_MINUS:
 		if (g_map.width >= 1)
-			maped_resize_map(-1, 0);
+			TRACE ("maped_resize_map")
+				maped_resize_map(-1, 0);
 		cam_update_limits();
 		break;
 	case SDLK_EQUALS:
-		maped_resize_map(1, 0);
+		TRACE ("maped_resize_map")
+			maped_resize_map(1, 0);
 		cam_update_limits();
 		break;
 	case SDLK_LEFTBRACKET:
 		if (g_map.height >= 1)
-			maped_resize_map(0, -1);
+			TRACE ("maped_resize_map")
+				maped_resize_map(0, -1);
 		cam_update_limits();
 		break;
 	case SDLK_RIGHTBRACKET:
-		maped_resize_map(0, 1);
+		TRACE ("maped_resize_map")
+			maped_resize_map(0, 1);
 		cam_update_limits();
 		break;
 	// Open another map
@@ -194,7 +192,7 @@ void maped_handle_keydown(MapEd *ed, SDL_Keycode key)
 			char map_buffer[MAP_PATH_MAX];
 			if (spdl_input_string(map_buffer, MAP_PATH_MAX, "enter the path of the map to load") == -1)
 				PERR("failed to get map path");
-			switch (map_load_txt(map_buffer, true))
+			switch (TRACE_INT("map_load", map_load(map_buffer, true)))
 			{
 			case ERR_NO_RECOVER:
 				abort();
@@ -208,9 +206,9 @@ void maped_handle_keydown(MapEd *ed, SDL_Keycode key)
 	case SDLK_p:
 		if (g_map.editing)
 		{
-			if (map_save_txt(g_map.path))
+			if (map_save(g_map.path))
 			{
-				PERR("map save fail: map_save_txt() failed");
+				PERR("map save fail: map_save() failed");
 			}
 			else
 			{
@@ -406,22 +404,18 @@ void maped_tile(MapEd *ed)
 
 			for (int y = top; y < bottom; ++y)
 				for (int x = left; x < right; ++x)
-					g_tile_map[y][x] = tid;
+					tile_set(x, y, tid);
 		}
 		else
 		{
 			// Placing entity
 
 			// Entity tile to place for every covered tile
-			EntTile et;
-			if (ed->state == MAPED_STATE_TILING)
-				et = (EntTile) {true, ed->tile.etid};
-			else
-				et = (EntTile) {false, 0};
+			EntTileId etid = ed->state == MAPED_STATE_TILING ? ed->tile.etid : ENT_TILE_NONE;
 
 			for (int y = top; y < bottom; ++y)
 				for (int x = left; x < right; ++x)
-					g_ent_map[y][x] = et;
+					map_grid_set(&g_ent_map, x, y, etid);
 		}
 	}
 }
@@ -10,18 +10,10 @@
 #include <SDL2/SDL.h>
 
 #include "../entity/tile.h"	// for EntTileId
+#include "../map.h"		// for MapGrid
 #include "../tile/data.h"	// for TileId
 #include "../void_rect.h"
 
-// Entity tile type
-typedef struct{
-	// True if there's anything in the tile
-	bool active : 1;
-
-	// Id of entity tile
-	EntTileId etid : 5;
-} EntTile;
-
 // Tile type
 typedef enum{
 	MAPED_TILE_TILE,
@@ -80,8 +72,9 @@ typedef struct{
 
 } MapEd;
 
-// Pointer to 2d array containing entity tiles
-extern EntTile **g_ent_map;
+// Entity tile ids of the map, only allocated while editing
+// Empty tiles are ENT_TILE_NONE
+extern MapGrid g_ent_map;
 
 // Initializes the map editor, returns nonzero on error
 int maped_init(void);
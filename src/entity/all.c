@@ -5,14 +5,40 @@
 #include "id.h"
 #include "array.h"
 #include "root.h"
+#include "grid.h"
+#include "c_body.h"
+#include "../barrier.h"
+#include "../camera.h"
+#include "../timestep.h"
 #include "all.h"
 
+// # of entities of each type drawn and culled by ENT_DRAW() in the last frame
+int g_ent_drawn[ENT_MAX];
+int g_ent_culled[ENT_MAX];
+
+// Adds a tick to an entity's time left to simulate and returns the timestep to update it with this tick, or 0 if it shouldn't be updated this tick
+// bounds is the entity's rectangle in the game world, near and far are its type's LOD distances (see ENT_UPDATE_LOD())
+float ent_lod_ts(EcmBase *base, const SDL_Rect *bounds, int near, int far)
+{
+	// Time that builds up while sleeping is capped, so entities don't take one huge step when they wake up
+	if ((base->lod_ts += g_ts) > ENT_LOD_TS_MAX)
+		base->lod_ts = ENT_LOD_TS_MAX;
+
+	const int x = bounds->x + bounds->w / 2;
+	const int y = bounds->y + bounds->h / 2;
+	if (!cam_can_see_point(x, y, near) && (base->lod_ts < ENT_LOD_TS_MAX || !cam_can_see_point(x, y, far)))
+		return 0.0f;
+
+	const float ts = base->lod_ts;
+	base->lod_ts = 0.0f;
+	return ts;
+}
+
 // Destroys all temporary entities (entities that don't continue to exist between map changes)
 void ent_destroy_temp(void)
 {
 	ent_array_reset(g_er[ENT_ID_ITEM]);
 	ent_array_reset(g_er[ENT_ID_FIREBALL]);
-	ent_array_reset(g_er[ENT_ID_PARTICLE]);
 	ent_array_reset(g_er[ENT_ID_RAGDOLL]);
 	ent_array_reset(g_er[ENT_ID_GROUNDGUY]);
 	ent_array_reset(g_er[ENT_ID_SLIDEGUY]);
@@ -22,4 +48,23 @@ void ent_destroy_temp(void)
 	ent_array_reset(g_er[ENT_ID_SAVEBIRD]);
 	ent_array_reset(g_er[ENT_ID_BARRIER]);
 	ent_array_reset(g_er[ENT_ID_COOLEGG]);
+	for (int i = 1; i < ENT_MAX; i++)
+		ent_grid_dirty(i);
+	ent_spawn_reset();
+	ecm_body_reset();
+	barrier_reset();
+}
+
+// Deletes all entities marked for deletion from every entity array
+// This should be called once at the end of every simulation tick
+void ent_clean_all(void)
+{
+	for (int i = 1; i < ENT_MAX; i++)
+	{
+		if (g_er[i]->status == ENT_ARRAY_CLEAN)
+		{
+			ent_array_clean(g_er[i]);
+			ent_grid_dirty(i);
+		}
+	}
 }
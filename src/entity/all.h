@@ -8,7 +8,6 @@
 #include "player.h"
 #include "item.h"
 #include "fireball.h"
-#include "particle.h"
 #include "ragdoll.h"
 #include "groundguy.h"
 #include "cloud.h"
@@ -20,26 +19,161 @@
 #include "barrier.h"
 #include "coolegg.h"
 
+#include "../camera.h"
+#include "../job.h"
+#include "../prof.h"
+#include "../timestep.h"
+
+// If defined, ENT_UPDATE_LOD() updates entities far from the camera less often
+#define	ENT_LOD_ENABLED
+
+// Entities far from the camera are updated once this many ticks have built up, and sleeping entities catch up on at most this many ticks when they wake up
+#define	ENT_LOD_TS_MAX	2.0f
+
+// Entities are only drawn if the rectangles from their ENT_BOUNDS_<name>() macros are within this many pixels of the screen
+// The leeway covers entities being drawn between their positions on the last two ticks
+#define	ENT_CULL_LEEWAY	32
+
+// # of entities of each type drawn and culled by ENT_DRAW() in the last frame
+extern int g_ent_drawn[ENT_MAX];
+extern int g_ent_culled[ENT_MAX];
+
 // Macros for updating and drawing lists of entities
 #define	ENT_ARR(name)		g_er[ENT_ID_##name]
 
+// Entities are iterated through one chunk at a time
+// Entities spawned while iterating are put in spawn queues (see spawn.h), so the length of the array doesn't change
+// Entities marked for deletion aren't updated, and they're deleted by ent_clean_all() at the end of the tick
 #define	ENT_UPDATE(name)	{ \
-					Ent##name *name##_ptr; \
-					name##_ptr = (Ent##name *) ENT_ARR(name)->e; \
-					for (int i = 0; i < ENT_ARR(name)->len; i++) \
-						ent_update_##name(name##_ptr++); \
-					if (ENT_ARR(name)->status == ENT_ARRAY_CLEAN) \
-						ent_array_clean(ENT_ARR(name)); \
+					PROF_START(PROF_ENT_UPDATE + ENT_ID_##name); \
+					const int name##_len = ENT_ARR(name)->len; \
+					for (int i = 0; i < name##_len; ) \
+					{ \
+						Ent##name *name##_ptr = (Ent##name *) ENT_ARR(name)->chunk[i >> ENT_CHUNK_SHIFT]; \
+						do \
+						{ \
+							if (name##_ptr->base.status != ENT_STAT_DEL) \
+								ent_update_##name(name##_ptr); \
+							name##_ptr++; \
+						} \
+						while (++i < name##_len && (i & ENT_CHUNK_MASK) != 0); \
+					} \
+					PROF_STOP(PROF_ENT_UPDATE + ENT_ID_##name); \
+				}
+
+/*
+ * ENT_UPDATE_LOD() updates entities at a rate based on how far they are from the screen. Each entity type updated with it defines ENT_LOD_NEAR_<name> and ENT_LOD_FAR_<name>, which are distances in pixels from the edges of the screen. Entities within the near distance are updated every tick, entities within the far distance are updated with a timestep of ENT_LOD_TS_MAX every ENT_LOD_TS_MAX ticks, and entities past the far distance sleep until they come closer.
+ *
+ * The near distance should be far enough off screen that entities being updated less often can't be seen.
+ */
+#ifdef	ENT_LOD_ENABLED
+	#define	ENT_UPDATE_LOD(name)	{ \
+						PROF_START(PROF_ENT_UPDATE + ENT_ID_##name); \
+						const double name##_ts = g_ts; \
+						const int name##_len = ENT_ARR(name)->len; \
+						for (int i = 0; i < name##_len; ) \
+						{ \
+							Ent##name *name##_ptr = (Ent##name *) ENT_ARR(name)->chunk[i >> ENT_CHUNK_SHIFT]; \
+							do \
+							{ \
+								if (name##_ptr->base.status != ENT_STAT_DEL) \
+								{ \
+									const float name##_lod_ts = ent_lod_ts(&name##_ptr->base, &ENT_BOUNDS_##name(name##_ptr), ENT_LOD_NEAR_##name, ENT_LOD_FAR_##name); \
+									if (name##_lod_ts > 0.0f) \
+									{ \
+										g_ts = name##_lod_ts; \
+										ent_update_##name(name##_ptr); \
+										g_ts = name##_ts; \
+									} \
+								} \
+								name##_ptr++; \
+							} \
+							while (++i < name##_len && (i & ENT_CHUNK_MASK) != 0); \
+						} \
+						PROF_STOP(PROF_ENT_UPDATE + ENT_ID_##name); \
+					}
+#else
+	#define	ENT_UPDATE_LOD(name)	ENT_UPDATE(name)
+#endif
+
+/*
+ * ENT_UPDATE_JOBS() updates the entities of a type in jobs (see job.h), using the function that ENT_UPDATE_RANGE_FUNC() or ENT_UPDATE_LOD_RANGE_FUNC() defines for the type. Only types whose update functions change nothing but the entity being updated can be updated this way. Anything else, like destroying the entity or spawning other entities, has to be done through job_cmd().
+ *
+ * Spawned entities are queued by the spawn queue and the commands that spawn them run after the jobs, so the length of the array doesn't change while jobs run.
+ */
+#define	ENT_UPDATE_JOBS(name)	{ \
+					PROF_START(PROF_ENT_UPDATE + ENT_ID_##name); \
+					job_run(ent_update_range_##name, ENT_ARR(name)->len); \
+					PROF_STOP(PROF_ENT_UPDATE + ENT_ID_##name); \
 				}
 
+// Defines a static function that updates the entities of a type from index start to end - 1, used by ENT_UPDATE_JOBS()
+#define	ENT_UPDATE_RANGE_FUNC(name)	static void ent_update_range_##name(int start, int end) \
+					{ \
+						for (int i = start; i < end; i++) \
+						{ \
+							Ent##name *name##_ptr = ENT_ARRAY_AT(ENT_ARR(name), i); \
+							if (name##_ptr->base.status != ENT_STAT_DEL) \
+								ent_update_##name(name##_ptr); \
+						} \
+					}
+
+// Defines a static function that updates the entities of a type from index start to end - 1 like ENT_UPDATE_LOD(), used by ENT_UPDATE_JOBS()
+#ifdef	ENT_LOD_ENABLED
+	#define	ENT_UPDATE_LOD_RANGE_FUNC(name)	static void ent_update_range_##name(int start, int end) \
+						{ \
+							const double name##_ts = g_ts; \
+							for (int i = start; i < end; i++) \
+							{ \
+								Ent##name *name##_ptr = ENT_ARRAY_AT(ENT_ARR(name), i); \
+								if (name##_ptr->base.status != ENT_STAT_DEL) \
+								{ \
+									const float name##_lod_ts = ent_lod_ts(&name##_ptr->base, &ENT_BOUNDS_##name(name##_ptr), ENT_LOD_NEAR_##name, ENT_LOD_FAR_##name); \
+									if (name##_lod_ts > 0.0f) \
+									{ \
+										g_ts = name##_lod_ts; \
+										ent_update_##name(name##_ptr); \
+										g_ts = name##_ts; \
+									} \
+								} \
+							} \
+						}
+#else
+	#define	ENT_UPDATE_LOD_RANGE_FUNC(name)	ENT_UPDATE_RANGE_FUNC(name)
+#endif
+
+// Entities that are off screen are culled instead of drawn
 #define	ENT_DRAW(name)		{ \
-					Ent##name *name##_ptr; \
-					name##_ptr = (Ent##name *) ENT_ARR(name)->e; \
-					for (int i = 0; i < ENT_ARR(name)->len; i++) \
-						ent_draw_##name(name##_ptr++); \
+					PROF_START(PROF_ENT_DRAW + ENT_ID_##name); \
+					g_ent_drawn[ENT_ID_##name] = 0; \
+					for (int i = 0; i < ENT_ARR(name)->len; ) \
+					{ \
+						Ent##name *name##_ptr = (Ent##name *) ENT_ARR(name)->chunk[i >> ENT_CHUNK_SHIFT]; \
+						do \
+						{ \
+							const SDL_Rect name##_bounds = ENT_BOUNDS_##name(name##_ptr); \
+							if (cam_can_see_rect(&name##_bounds, ENT_CULL_LEEWAY)) \
+							{ \
+								ent_draw_##name(name##_ptr); \
+								g_ent_drawn[ENT_ID_##name]++; \
+							} \
+							name##_ptr++; \
+						} \
+						while (++i < ENT_ARR(name)->len && (i & ENT_CHUNK_MASK) != 0); \
+					} \
+					g_ent_culled[ENT_ID_##name] = ENT_ARR(name)->len - g_ent_drawn[ENT_ID_##name]; \
+					PROF_STOP(PROF_ENT_DRAW + ENT_ID_##name); \
 				}
 
+// Adds a tick to an entity's time left to simulate and returns the timestep to update it with this tick, or 0 if it shouldn't be updated this tick
+// bounds is the entity's rectangle in the game world, near and far are its type's LOD distances (see ENT_UPDATE_LOD())
+float ent_lod_ts(EcmBase *base, const SDL_Rect *bounds, int near, int far);
+
 // Destroys all temporary entities (entities that don't continue to exist between map changes)
 void ent_destroy_temp(void);
 
+// Deletes all entities marked for deletion from every entity array
+// This should be called once at the end of every simulation tick
+void ent_clean_all(void);
+
 #endif
@@ -13,10 +13,20 @@
 #include "id.h"
 #include "c_base.h"
 #include "array.h"
+#include "grid.h"
 #include "root.h"
 
+// Allocates a new chunk at the end of an entity array, returns nonzero on error
+static int ent_array_chunk_add(EntArray *a);
+
+// Adds ENT_CHUNK_LEN free slots to the slot table of an entity array, returns nonzero on error
+static int ent_array_slot_grow(EntArray *a);
+
+// Frees the slot of the entity at e in entity array a, making handles to it invalid
+static void ent_array_slot_free(EntArray *a, const void *e);
+
 // Creates a new entity array and returns a pointer to it, returns NULL on error
-EntArray *ent_array_new(int len_max, size_t ent_size)
+EntArray *ent_array_new(size_t ent_size)
 {
 	EntArray *a;
 	if ((a = malloc(sizeof(EntArray))) == NULL)
@@ -24,90 +34,246 @@ EntArray *ent_array_new(int len_max, size_t ent_size)
 		PERR("failed to allocate mem for entity array struct\n");
 		return NULL;
 	}
-	if ((a->e = calloc(len_max, ent_size)) == NULL)
-	{
-		PERR("failed to allocate mem for entity array\n");
-		free(a);
-		return NULL;
-	}
 	a->status = ENT_ARRAY_NORM;
+	a->chunk = NULL;
+	a->chunk_len = 0;
+	a->chunk_len_max = 0;
 	a->ent_size = ent_size;
-	a->len_max = len_max;
 	a->len = 0;
+	a->slot = NULL;
+	a->slot_len = 0;
+	a->slot_free = -1;
 	return a;
 }
 
 // Frees an entity array
 void ent_array_free(EntArray *a)
 {
-	free(a->e);
+	ent_array_reset(a);
+	free(a->chunk);
+	free(a->slot);
 	free(a);
 }
 
 // Returns a pointer to space for a new entity in an entity array, returns NULL on error
 void *ent_array_add(EntArray *a)
 {
-	if (a->len == a->len_max)
-	{
-		// No more room in entity array
+	// Make room for the entity if there isn't any
+	if (a->len == a->chunk_len * ENT_CHUNK_LEN && ent_array_chunk_add(a))
+		return NULL;
+	if (a->slot_free == -1 && ent_array_slot_grow(a))
 		return NULL;
-	}
 
-	// Spooky pointer arithmetic to find a pointer to the first available space in the entity array
-	Byte *e = (Byte *) a->e;
-	e += a->ent_size * a->len;
+	Byte *e = ENT_ARRAY_AT(a, a->len);
+
+	// Take a slot from the free list
+	const int slot = a->slot_free;
+	a->slot_free = a->slot[slot].index;
+	a->slot[slot].index = a->len;
+	((EntBASE *) e)->base.slot = slot;
 
 	a->len++;
 	return (void *) e;
 }
 
+// Adds len entities copied from ents to the end of the entity array at g_er[id]
+// Returns nonzero on error, in which case only some of the entities may have been added
+int ent_array_append(EntId id, const void *ents, int len)
+{
+	EntArray *a = g_er[id];
+	ent_grid_dirty(id);
+
+	// Make room for all of the entities
+	while (a->len + len > a->chunk_len * ENT_CHUNK_LEN)
+		if (ent_array_chunk_add(a))
+			return 1;
+
+	const Byte *src = ents;
+	const int len_end = a->len + len;
+	while (a->len < len_end)
+	{
+		// Copy as many entities as fit in the chunk at the end of the array at once
+		int n = ENT_CHUNK_LEN - (a->len & ENT_CHUNK_MASK);
+		if (n > len_end - a->len)
+			n = len_end - a->len;
+		Byte *dest = ENT_ARRAY_AT(a, a->len);
+		memcpy(dest, src, n * a->ent_size);
+		src += n * a->ent_size;
+
+		// Give each entity a slot
+		for (int i = 0; i < n; i++, dest += a->ent_size)
+		{
+			if (a->slot_free == -1 && ent_array_slot_grow(a))
+				return 1;
+			const int slot = a->slot_free;
+			a->slot_free = a->slot[slot].index;
+			a->slot[slot].index = a->len++;
+			((EntBASE *) dest)->base.slot = slot;
+		}
+	}
+	return 0;
+}
+
 // Deletes an entity from an entity array at g_er[id] at index i
 void ent_array_del(EntId id, int index)
 {
 	EntArray *a = g_er[id];
 	a->len--;
+	ent_grid_dirty(id);
 
-	Byte *dest = (Byte *) a->e;
-	Byte *src = dest;
+	Byte *dest = ENT_ARRAY_AT(a, index);
+	Byte *src = ENT_ARRAY_AT(a, a->len);
+
+	ent_array_slot_free(a, dest);
+	if (index == a->len)
+		return;
 
 	// Copy mem from last entity to entity being deleted
-	dest += a->ent_size * index;
-	src += a->ent_size * a->len;
 	memcpy((void *) dest, (void *) src, a->ent_size);
 
 	// Set the new index of the moved entity
-	((EntBASE *) dest)->base.index = index;
+	a->slot[((EntBASE *) dest)->base.slot].index = index;
 }
 
 // Deletes all entities from an entity array with a status of ENT_STAT_DEL (defined in c_base.h)
 // This should only be called on an entity array with a status of ENT_ARRAY_CLEAN
+// The remaining entities are moved down to fill the gaps in one pass, keeping their order
 void ent_array_clean(EntArray *a)
 {
-	Byte *e = (Byte *) a->e;
-	EcmBase *b;
+	// Index that the next remaining entity is moved to
+	int dest = 0;
+
 	for (int i = 0; i < a->len; i++)
 	{
-		if ((b = &(((EntBASE *) e)->base))->status == ENT_STAT_DEL)
+		EntBASE *e = ENT_ARRAY_AT(a, i);
+		if (e->base.status == ENT_STAT_DEL)
 		{
 			// Entity is marked for deletion
-			ent_array_del(b->id, b->index);
-
-			// i must be decremented to not skip over the entity that has just taken the place of the deleted entity
-			i--;
+			ent_array_slot_free(a, e);
+			continue;
 		}
-		else
+
+		// Move the entity down if entities before it were deleted
+		if (dest != i)
 		{
-			// Entity wasn't marked for deletion, move to next entity
-			e += a->ent_size;
+			memcpy(ENT_ARRAY_AT(a, dest), e, a->ent_size);
+			a->slot[e->base.slot].index = dest;
 		}
+		dest++;
 	}
+	a->len = dest;
 
 	// Remove ENT_ARRAY_CLEAN status
 	a->status = ENT_ARRAY_NORM;
 }
 
-// Deletes all of the entities in an array
+// Deletes all of the entities in an array and frees its chunks
 void ent_array_reset(EntArray *a)
 {
+	for (int i = 0; i < a->len; i++)
+		ent_array_slot_free(a, ENT_ARRAY_AT(a, i));
 	a->len = 0;
+
+	for (int i = 0; i < a->chunk_len; i++)
+		free(a->chunk[i]);
+	a->chunk_len = 0;
+}
+
+// Returns the # of bytes of memory allocated for an entity array
+size_t ent_array_mem_size(const EntArray *a)
+{
+	return sizeof(EntArray)
+		+ (size_t) a->chunk_len * ENT_CHUNK_LEN * a->ent_size
+		+ (size_t) a->chunk_len_max * sizeof(void *)
+		+ (size_t) a->slot_len * sizeof(EntSlot);
+}
+
+// Returns a handle to the entity at e
+EntHandle ent_handle(const void *e)
+{
+	const EcmBase *b = &((const EntBASE *) e)->base;
+	return (EntHandle) {b->slot, g_er[b->id]->slot[b->slot].gen};
+}
+
+// Returns a pointer to the entity that handle h refers to in g_er[id]
+// Returns NULL if the entity was deleted or is marked for deletion
+void *ent_handle_get(EntId id, EntHandle h)
+{
+	EntArray *a = g_er[id];
+	if (h.slot < 0 || h.slot >= a->slot_len || a->slot[h.slot].gen != h.gen)
+		return NULL;
+
+	EntBASE *e = ENT_ARRAY_AT(a, a->slot[h.slot].index);
+	if (e->base.status == ENT_STAT_DEL)
+		return NULL;
+	return e;
+}
+
+// Returns true if handle h refers to an entity in g_er[id] that hasn't been deleted or marked for deletion
+bool ent_handle_valid(EntId id, EntHandle h)
+{
+	return ent_handle_get(id, h) != NULL;
+}
+
+// Allocates a new chunk at the end of an entity array, returns nonzero on error
+static int ent_array_chunk_add(EntArray *a)
+{
+	// Make room for the chunk pointer
+	if (a->chunk_len == a->chunk_len_max)
+	{
+		const int len_max = a->chunk_len_max == 0 ? 4 : a->chunk_len_max * 2;
+		void **chunk = realloc(a->chunk, len_max * sizeof(void *));
+		if (chunk == NULL)
+		{
+			PERR("failed to allocate mem for entity array chunk pointers");
+			return 1;
+		}
+		a->chunk = chunk;
+		a->chunk_len_max = len_max;
+	}
+
+	if ((a->chunk[a->chunk_len] = malloc(ENT_CHUNK_LEN * a->ent_size)) == NULL)
+	{
+		PERR("failed to allocate mem for entity array chunk");
+		return 1;
+	}
+	a->chunk_len++;
+	return 0;
+}
+
+// Adds ENT_CHUNK_LEN free slots to the slot table of an entity array, returns nonzero on error
+static int ent_array_slot_grow(EntArray *a)
+{
+	if (a->slot_len > ECM_BASE_SLOT_MAX - ENT_CHUNK_LEN)
+	{
+		PERR("entity array slot table is full");
+		return 1;
+	}
+	const int len = a->slot_len + ENT_CHUNK_LEN;
+	EntSlot *slot = realloc(a->slot, len * sizeof(EntSlot));
+	if (slot == NULL)
+	{
+		PERR("failed to allocate mem for entity array slot table");
+		return 1;
+	}
+	a->slot = slot;
+
+	// Link the new slots into the free list
+	for (int i = a->slot_len; i < len; i++)
+	{
+		a->slot[i].index = i + 1 < len ? i + 1 : a->slot_free;
+		a->slot[i].gen = 0;
+	}
+	a->slot_free = a->slot_len;
+	a->slot_len = len;
+	return 0;
+}
+
+// Frees the slot of the entity at e in entity array a, making handles to it invalid
+static void ent_array_slot_free(EntArray *a, const void *e)
+{
+	const int slot = ((const EntBASE *) e)->base.slot;
+	a->slot[slot].gen++;
+	a->slot[slot].index = a->slot_free;
+	a->slot_free = slot;
 }
@@ -1,16 +1,35 @@
 /*
  * array.h contains types and functions for entity arrays.
+ *
+ * Entities are stored in chunks of ENT_CHUNK_LEN entities. Chunks are allocated when an array runs out of room and freed when the array is reset, so arrays only take up as much memory as the most entities they've held since the last map change. Entities never move to another chunk when chunks are added, so iterating through the entities in a chunk is as fast as iterating through a plain array. ENT_ARRAY_AT() finds the entity at any index.
+ *
+ * Entities are stored packed together at the start of their array, so deleting one moves the last entity in the array into its place. This means pointers to entities and their indexes can point to a different entity after any deletion. Entities that need to be referred to later should be referred to with handles instead.
+ *
+ * Each entity array has a slot table that holds the index of each entity in the array. An entity keeps the same slot for its whole life, even when it's moved, and only its slot's index is changed. A handle holds a slot and the generation of the slot at the time the handle was made. Slot generations are increased when their entities are deleted, so a handle to a deleted entity will never find the entity that reuses its slot.
  */
 
 #ifndef	ENTITY_ARRAY_H
 #define	ENTITY_ARRAY_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
 #include "../util/type.h"	// For Byte
 #include "id.h"
 
+// # of entities in a chunk is 2 to the power of this
+#define	ENT_CHUNK_SHIFT	6
+
+// # of entities in a chunk
+#define	ENT_CHUNK_LEN	(1 << ENT_CHUNK_SHIFT)
+
+// Mask that gets the index of an entity in its chunk from its index in its array
+#define	ENT_CHUNK_MASK	(ENT_CHUNK_LEN - 1)
+
+// Returns a pointer to the entity at index i in entity array a
+#define	ENT_ARRAY_AT(a, i)	((void *) ((Byte *) (a)->chunk[(i) >> ENT_CHUNK_SHIFT] + (a)->ent_size * ((i) & ENT_CHUNK_MASK)))
+
 typedef enum{
 	ENT_ARRAY_NORM,
 
@@ -18,24 +37,58 @@ typedef enum{
 	ENT_ARRAY_CLEAN,
 } EntArrayStatus;
 
+// A slot in an entity array's slot table
+typedef struct{
+	// Index of the slot's entity in the array if the slot is used, or the next free slot (-1 if there is none) if it isn't
+	int index;
+
+	// Generation of the slot, increased whenever the slot's entity is deleted
+	unsigned int gen;
+} EntSlot;
+
+// Handle to an entity
+typedef struct{
+	// Slot of the entity in its entity array's slot table
+	int slot;
+
+	// Generation of the slot when the handle was made
+	unsigned int gen;
+} EntHandle;
+
+// Handle that never refers to an entity
+#define	ENT_HANDLE_NONE	((EntHandle) {-1, 0})
+
 typedef struct{
 	EntArrayStatus status;
 	
-	// Array of entities
-	void *e;
+	// Array of pointers to chunks of entities
+	void **chunk;
+
+	// # of chunks allocated
+	int chunk_len;
+
+	// # of chunk pointers that the chunk pointer array has room for
+	int chunk_len_max;
 
 	// Size of a single entity in the array
 	size_t ent_size;
 
-	// Max # of entities the array can hold
-	int len_max;
-
 	// Current # of entities in the array
 	int len;
+
+	// Slot table
+	// Slots are never freed, so handles to deleted entities stay invalid after the array is reset
+	EntSlot *slot;
+
+	// # of slots in the slot table
+	int slot_len;
+
+	// First free slot in the slot table, or -1 if there is none
+	int slot_free;
 } EntArray;
 
 // Creates a new entity array and returns a pointer to it, returns NULL on error
-EntArray *ent_array_new(int len_max, size_t ent_size);
+EntArray *ent_array_new(size_t ent_size);
 
 // Frees an entity array
 void ent_array_free(EntArray *a);
@@ -43,13 +96,30 @@ void ent_array_free(EntArray *a);
 // Returns a pointer to space for a new entity in an entity array, returns NULL on error
 void *ent_array_add(EntArray *a);
 
+// Adds len entities copied from ents to the end of the entity array at g_er[id]
+// Returns nonzero on error, in which case only some of the entities may have been added
+int ent_array_append(EntId id, const void *ents, int len);
+
 // Deletes an entity from an entity array at g_er[id] at index i
 void ent_array_del(EntId id, int i);
 
 // Deletes all entities from an entity array with a status of ENT_STAT_DEL (defined in c_base.h)
 void ent_array_clean(EntArray *a);
 
-// Deletes all of the entities in an array
+// Deletes all of the entities in an array and frees its chunks
 void ent_array_reset(EntArray *a);
 
+// Returns the # of bytes of memory allocated for an entity array
+size_t ent_array_mem_size(const EntArray *a);
+
+// Returns a handle to the entity at e
+EntHandle ent_handle(const void *e);
+
+// Returns a pointer to the entity that handle h refers to in g_er[id]
+// Returns NULL if the entity was deleted or is marked for deletion
+void *ent_handle_get(EntId id, EntHandle h);
+
+// Returns true if handle h refers to an entity in g_er[id] that hasn't been deleted or marked for deletion
+bool ent_handle_valid(EntId id, EntHandle h);
+
 #endif
@@ -6,15 +6,16 @@
 
 #include "../camera.h"
 #include "../error.h"
+#include "../particle.h"
 #include "../texture.h"
 #include "../tile/data.h"	// For g_tile_map
+#include "../tile/plane.h"	// For tile_set()
 #include "../util/rep.h"
 #include "../video.h"
 
 #include "entity.h"
 
 #include "barrier.h"
-#include "particle.h"
 
 EntBARRIER *ent_new_BARRIER(int x, int y, BarrierTag btag)
 {
@@ -22,7 +23,8 @@ EntBARRIER *ent_new_BARRIER(int x, int y, BarrierTag btag)
 	e->x = x;
 	e->y = y;
 	e->btag = btag;
-	g_tile_map[e->y / 32][e->x / 32] = TILE_INVIS;
+	barrier_add_barrier(btag, ent_handle(e), &e->next);
+	tile_set(e->x / 32, e->y / 32, TILE_INVIS);
 	PINF("barrier with btag %d created", (int) btag);
 	return e;
 }
@@ -52,7 +54,7 @@ void ent_draw_BARRIER(EntBARRIER *e)
 void ent_destroy_BARRIER(EntBARRIER *e)
 {
 	REP (10)
-		ent_new_PARTICLE(e->x + TILE_SIZE / 2, e->y + TILE_SIZE / 2, PTCL_FLAME);
-	g_tile_map[e->y / 32][e->x / 32] = TILE_AIR;
+		ptcl_new(e->x + TILE_SIZE / 2, e->y + TILE_SIZE / 2, PTCL_FLAME);
+	tile_set(e->x / 32, e->y / 32, TILE_AIR);
 	ENT_DEL_MARK(e);
 }
@@ -8,6 +8,7 @@
 #define	ENTITY_BARRIER_H
 
 #include "../barrier.h"
+#include "../tile/data.h"	// For TILE_SIZE
 
 #include "entity.h"
 
@@ -19,8 +20,14 @@ typedef struct{
 	int x, y;
 
 	BarrierTag btag;
+
+	// Handle to the next barrier with the same tag (see ../barrier.h)
+	EntHandle next;
 } EntBARRIER;
 
+// Rectangle in the game world that a barrier is drawn in
+#define	ENT_BOUNDS_BARRIER(ent)	((SDL_Rect) {(ent)->x, (ent)->y, TILE_SIZE, TILE_SIZE})
+
 EntBARRIER *ent_new_BARRIER(int x, int y, BarrierTag btag);
 void ent_update_BARRIER(EntBARRIER *e);
 void ent_draw_BARRIER(EntBARRIER *e);
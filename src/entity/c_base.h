@@ -1,7 +1,9 @@
 /*
  * c_base.h contains the EcmBase struct and EcmStat enum.
  *
- * The EcmBase struct contains basic data required in every entity struct. This includes the entity's status, id, and index in its entity array.
+ * The EcmBase struct contains basic data required in every entity struct. This includes the entity's status, id, slot in its entity array's slot table (see array.h), and time it has left to catch up on if it's updated at a lower rate when it's far from the camera (see all.h).
+ *
+ * When ENT_COMPACT is defined, entity structs use a compact layout that fits more entities in each cache line read by their update loops. The base header packs the status, id and slot into 4 bytes, bodies and turrets store positions and angles as floats instead of doubles (see EcmReal), and animation state is packed into bit fields with ENT_COMPACT_BITS(). Run the game with --sizes to see the size of every entity type in the current layout.
  *
  * IMPORTANT: For proper data alignment and macro handling, an EcmBase variable named "base" must be the first variable declared in an entity struct.
  */
@@ -9,8 +11,30 @@
 #ifndef	ENTITY_C_BASE_H
 #define	ENTITY_C_BASE_H
 
+#include <limits.h>
+
 #include "id.h"	// For EntId
 
+// Define this to use the compact entity layout (see header comment)
+// It's not defined by default because positions stored as floats change the results of the simulation, so replays recorded with one layout won't reach the same game state with the other
+#ifdef	ENT_COMPACT
+	// Type of positions and angles that are stored as doubles in the default layout
+	typedef float EcmReal;
+
+	// Makes a struct member a bit field of n bits
+	#define	ENT_COMPACT_BITS(n)	: n
+
+	// # of bits in the slot of an EcmBase
+	#define	ECM_BASE_SLOT_BITS	24
+
+	// Max # of slots in an entity array's slot table
+	#define	ECM_BASE_SLOT_MAX	(1 << ECM_BASE_SLOT_BITS)
+#else
+	typedef double EcmReal;
+	#define	ENT_COMPACT_BITS(n)
+	#define	ECM_BASE_SLOT_MAX	INT_MAX
+#endif
+
 // Entity status
 typedef enum{
 	// Normal status
@@ -22,11 +46,22 @@ typedef enum{
 
 // See header comment for info on what this is
 typedef struct{
+#ifdef	ENT_COMPACT
+	unsigned int status : 1;
+	unsigned int id : 7;
+
+	// Slot in the entity array's slot table, which holds the entity's index in the array
+	unsigned int slot : ECM_BASE_SLOT_BITS;
+#else
 	EcmStat status;
 	EntId id;
 
-	// Index in entity array that the pointer to the entity is stored in
-	int index;
+	// Slot in the entity array's slot table, which holds the entity's index in the array
+	int slot;
+#endif
+
+	// Time in ticks that hasn't been simulated yet for entities updated with ENT_UPDATE_LOD() (see all.h)
+	float lod_ts;
 } EcmBase;
 
 /*
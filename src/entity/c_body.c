@@ -2,82 +2,271 @@
  * c_body.c contains functions that act on EcmBody structs.
  */
 
+#include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <SDL2/SDL.h>
 
-#include "../util/math.h"	// For signf()
 #include "../tile/data.h"	// For tile flags
-#include "../collision.h"	// check_tile_rect_flags()
+#include "../collision.h"	// For tile collision functions
 #include "../error.h"
+#include "../job.h"
 #include "../timestep.h"
 #include "c_body.h"
 
-// Checks for an entity body collision with a solid tile
-bool ecm_body_tile_collide(EcmBody *b, double xshift, double yshift)
+// Bodies in the body store, packed together in no particular order
+EcmBody *g_ecm_body = NULL;
+
+// Index in g_ecm_body of the body with each id
+int *g_ecm_body_index = NULL;
+
+// # of bodies in the store and # of bodies there's room for
+static int g_ecm_body_len = 0;
+static int g_ecm_body_len_max = 0;
+
+// Next id that isn't used by a body, ids up to this that aren't used are in the free list
+static int g_ecm_body_id_len = 0;
+
+// First id in the free list, or -1 if it's empty
+// Each free id's entry in g_ecm_body_index holds the next free id
+static int g_ecm_body_id_free = -1;
+
+// Moves an entity body horizontally with timestep ts, returns true if a tile is collided with
+static bool ecm_body_move_hori_ts(EcmBody *b, double ts);
+
+// Moves an entity body vertically with timestep ts, returns true if a tile is collided with
+static bool ecm_body_move_vert_ts(EcmBody *b, double ts);
+
+// Finds the first solid tile that a body runs into if it's moved by dx or dy (only one of which can be nonzero)
+// Returns true and fills in *hit if a tile is found
+static bool ecm_body_sweep(const EcmBody *b, double dx, double dy, TileHit *hit);
+
+// Moves bodies start to end - 1 in the body store, used as a job function
+static void ecm_body_update_range(int start, int end);
+
+// Moves a body in the body store by one pass
+static void ecm_body_update(EcmBody *b);
+
+// Returns true if there's a solid tile right under an entity body shifted horizontally by xshift
+bool ecm_body_tile_below(const EcmBody *b, double xshift)
 {
-	// Collision rectangle
-	SDL_Rect crect = {
-		b->x + xshift,
-		b->y + yshift,
-		b->w,
-		b->h,
-	};
-
-	return check_tile_rect_flags(&crect, TFLAG_SOLID);
+	const int x = floor(b->x + xshift);
+	return check_tile_row_flags((int) floor(b->y) + b->h + 1, x, x + b->w, TFLAG_SOLID) != TILE_AIR;
 }
 
 // Moves an entity body horizontally, returns true if a tile is collided with
 bool ecm_body_move_hori(EcmBody *b)
 {
-	// Check if there is a solid tile in front of us
-	if (ecm_body_tile_collide(b, b->hsp * g_ts, 0))
-	{
-		// Current hsp sign
-		int csign = signf(b->hsp);
+	return ecm_body_move_hori_ts(b, g_ts);
+}
 
-		// Tile x coordinate of the tile we are moving into
-		int tile_x = ((int) (b->x + b->hsp * g_ts)) / TILE_SIZE + 1;
+// Moves an entity body vertically, returns true if a tile is collided with
+bool ecm_body_move_vert(EcmBody *b)
+{
+	return ecm_body_move_vert_ts(b, g_ts);
+}
 
-		// Align the body with the tile based on the direction it's moving in
-		if (csign == 1)
+// Adds a copy of body b to the body store and returns its id, returns -1 on error
+EcmBodyId ecm_body_new(const EcmBody *b)
+{
+	// Make room for the body and its id if there isn't any
+	// Ids are never used by more than one body, so there's an id for every body there's room for
+	if (g_ecm_body_len == g_ecm_body_len_max)
+	{
+		const int len_max = g_ecm_body_len_max == 0 ? ECM_BODY_LEN_MIN : g_ecm_body_len_max * 2;
+		EcmBody *body = realloc(g_ecm_body, sizeof(EcmBody) * len_max);
+		if (body == NULL)
 		{
-			b->x = tile_x * TILE_SIZE - b->w - 1;
+			PERR("failed to allocate mem for body store");
+			return -1;
 		}
-		else if (csign == -1)
+		g_ecm_body = body;
+		int *index = realloc(g_ecm_body_index, sizeof(int) * len_max);
+		if (index == NULL)
 		{
-			b->x = tile_x * TILE_SIZE;
+			PERR("failed to allocate mem for body store ids");
+			return -1;
 		}
-		return true;
+		g_ecm_body_index = index;
+		g_ecm_body_len_max = len_max;
 	}
-	b->x += b->hsp * g_ts;
-	return false;
+
+	EcmBodyId id;
+	if (g_ecm_body_id_free != -1)
+	{
+		id = g_ecm_body_id_free;
+		g_ecm_body_id_free = g_ecm_body_index[id];
+	}
+	else
+		id = g_ecm_body_id_len++;
+
+	EcmBody *dest = &g_ecm_body[g_ecm_body_len];
+	*dest = *b;
+	dest->ts = 0.0f;
+	dest->flags |= ECM_BODY_NEW;
+	dest->hit = 0;
+	dest->id = id;
+	g_ecm_body_index[id] = g_ecm_body_len++;
+	return id;
 }
 
-// Moves an entity body vertically, returns true if a tile is collided with
-bool ecm_body_move_vert(EcmBody *b)
+// Frees a body in the body store
+void ecm_body_del(EcmBodyId id)
 {
-	// Check if there is a solid tile in front of us
-	if (ecm_body_tile_collide(b, 0, b->vsp * g_ts))
+	// Move the last body into the freed body's place
+	const int index = g_ecm_body_index[id];
+	if (index != --g_ecm_body_len)
 	{
-		// Current vsp sign
-		int csign = signf(b->vsp);
+		g_ecm_body[index] = g_ecm_body[g_ecm_body_len];
+		g_ecm_body_index[g_ecm_body[index].id] = index;
+	}
+
+	g_ecm_body_index[id] = g_ecm_body_id_free;
+	g_ecm_body_id_free = id;
+}
 
-		// Tile y coordinate of the tile we are moving into
-		int tile_y = ((int) (b->y + b->vsp * g_ts)) / TILE_SIZE + 1;
+// Moves every body in the body store with its timestep, then sets the timesteps to 0
+void ecm_body_update_all(void)
+{
+	// Bodies only read tiles and change themselves, so they can all be moved in jobs
+	job_run(ecm_body_update_range, g_ecm_body_len);
+}
+
+// Frees every body in the body store
+void ecm_body_reset(void)
+{
+	g_ecm_body_len = 0;
+	g_ecm_body_id_len = 0;
+	g_ecm_body_id_free = -1;
+}
+
+// Frees all memory used by the body store
+void ecm_body_free(void)
+{
+	free(g_ecm_body);
+	free(g_ecm_body_index);
+	g_ecm_body = NULL;
+	g_ecm_body_index = NULL;
+	g_ecm_body_len_max = 0;
+	ecm_body_reset();
+}
 
-		// Align the body with the tile based on the direction it's moving in
-		if (csign == 1)
+// Returns the # of bodies in the body store
+int ecm_body_count(void)
+{
+	return g_ecm_body_len;
+}
+
+// Returns the # of bytes allocated for the body store
+size_t ecm_body_mem_size(void)
+{
+	return (size_t) g_ecm_body_len_max * (sizeof(EcmBody) + sizeof(int));
+}
+
+// Moves bodies start to end - 1 in the body store, used as a job function
+static void ecm_body_update_range(int start, int end)
+{
+	for (int i = start; i < end; i++)
+		ecm_body_update(&g_ecm_body[i]);
+}
+
+// Moves a body in the body store by one pass
+static void ecm_body_update(EcmBody *b)
+{
+	ECM_BODY_SAVE_PREV(*b);
+	if (b->flags & ECM_BODY_NEW)
+	{
+		b->flags &= ~ECM_BODY_NEW;
+		b->ts = g_ts;
+	}
+	if (b->ts == 0.0f)
+		return;
+
+	// Hits are kept until the body is moved again, so entities that sleep through a pass still see them
+	const double ts = b->ts;
+	b->ts = 0.0f;
+	b->hit = 0;
+
+	TileHit hit;
+	if (b->flags & ECM_BODY_BOUNCE)
+	{
+		if (ecm_body_sweep(b, b->hsp * ts, 0, &hit))
 		{
-			b->y = tile_y * TILE_SIZE - b->h - 1;
+			b->x = hit.pos;
+			b->hsp *= -ECM_BODY_BOUNCE_KEEP;
+			b->hit |= ECM_BODY_HIT_HORI;
 		}
-		else if (csign == -1)
+		else
+			b->x += b->hsp * ts;
+	}
+	else if (ecm_body_move_hori_ts(b, ts))
+		b->hit |= ECM_BODY_HIT_HORI;
+	else if ((b->flags & ECM_BODY_LEDGES) && !ecm_body_tile_below(b, b->hsp * ts))
+		b->hit |= ECM_BODY_HIT_LEDGE;
+
+	b->vsp += b->grv * ts;
+	if (b->vsp_max != 0.0f)
+	{
+		if (b->vsp > b->vsp_max)
+			b->vsp = b->vsp_max;
+		else if (b->vsp < -b->vsp_max)
+			b->vsp = -b->vsp_max;
+	}
+
+	if (b->flags & ECM_BODY_BOUNCE)
+	{
+		if (ecm_body_sweep(b, 0, b->vsp * ts, &hit))
 		{
-			b->y = tile_y * TILE_SIZE;
+			b->y = hit.pos;
+			b->vsp *= -ECM_BODY_BOUNCE_KEEP;
+			b->hsp *= ECM_BODY_BOUNCE_FRICTION;
+			b->hit |= ECM_BODY_HIT_VERT;
 		}
+		else
+			b->y += b->vsp * ts;
+	}
+	else if (ecm_body_move_vert_ts(b, ts))
+		b->hit |= ECM_BODY_HIT_VERT;
+}
+
+// Moves an entity body horizontally with timestep ts, returns true if a tile is collided with
+static bool ecm_body_move_hori_ts(EcmBody *b, double ts)
+{
+	TileHit hit;
+	if (ecm_body_sweep(b, b->hsp * ts, 0, &hit))
+	{
+		// Stop right next to the tile
+		b->x = hit.pos;
+		return true;
+	}
+	b->x += b->hsp * ts;
+	return false;
+}
+
+// Moves an entity body vertically with timestep ts, returns true if a tile is collided with
+static bool ecm_body_move_vert_ts(EcmBody *b, double ts)
+{
+	TileHit hit;
+	if (ecm_body_sweep(b, 0, b->vsp * ts, &hit))
+	{
+		// Stop right next to the tile
+		b->y = hit.pos;
 		return true;
 	}
-	b->y += b->vsp * g_ts;
+	b->y += b->vsp * ts;
 	return false;
 }
+
+// Finds the first solid tile that a body runs into if it's moved by dx or dy (only one of which can be nonzero)
+// Returns true and fills in *hit if a tile is found
+static bool ecm_body_sweep(const EcmBody *b, double dx, double dy, TileHit *hit)
+{
+	const int x = floor(b->x);
+	const int y = floor(b->y);
+	const SDL_Rect rect = {x, y, b->w, b->h};
+	if (dx != 0.0)
+		return check_tile_sweep_x(&rect, (int) floor(b->x + dx) - x, TFLAG_SOLID, hit);
+	return check_tile_sweep_y(&rect, (int) floor(b->y + dy) - y, TFLAG_SOLID, hit);
+}
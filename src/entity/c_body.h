@@ -2,18 +2,51 @@
  * c_body.h contains the EcmBody struct and its associted functions.
  *
  * The EcmBody struct is used to represent an entity body in the world. It contains position, hitbox, and movement speed data.
+ *
+ * Bodies of entities that move with the same physics rules (egg enemies and ragdolls) are kept in the body store instead of their entities. The store keeps every body packed together in one array, and ecm_body_update_all() moves them all in one pass near the start of every tick, before their entities are updated. Entities hold the ids of their bodies, which ECM_BODY() turns into pointers. Each entity sets the timestep its body is moved with in the next pass, reacts to the tiles its body hit in the last pass, and frees its body when it's destroyed.
  */
 
 #ifndef	ENTITY_C_BODY_H
 #define	ENTITY_C_BODY_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include <SDL2/SDL.h>
 
+#include "c_base.h"	// For EcmReal
+
+// # of bodies the body store has room for when it's first allocated
+#define	ECM_BODY_LEN_MIN	64
+
+// Flags for how ecm_body_update_all() moves a body
+// Bounce off of tiles instead of stopping at them
+#define	ECM_BODY_BOUNCE		(1 << 0)
+
+// Report ledges in front of the body with ECM_BODY_HIT_LEDGE
+#define	ECM_BODY_LEDGES		(1 << 1)
+
+// Set for bodies that haven't been moved yet, which are moved with g_ts because their entities haven't chosen a timestep
+#define	ECM_BODY_NEW		(1 << 2)
+
+// Flags for the tiles a body hit the last time it was moved
+#define	ECM_BODY_HIT_HORI	(1 << 0)
+#define	ECM_BODY_HIT_VERT	(1 << 1)
+#define	ECM_BODY_HIT_LEDGE	(1 << 2)
+
+// Fraction of a bouncing body's speed that's kept when it bounces
+#define	ECM_BODY_BOUNCE_KEEP	0.9f
+
+// Fraction of a bouncing body's horizontal speed that's kept when it bounces vertically
+#define	ECM_BODY_BOUNCE_FRICTION	0.98f
+
+// Id of a body in the body store
+typedef int EcmBodyId;
+
 typedef struct{
 	// Position
-	double x, y;
+	EcmReal x, y;
 
 	// Width and height
 	int w, h;
@@ -23,10 +56,40 @@ typedef struct{
 
 	// Gravity
 	float grv;
+
+	// Position on the previous simulation tick, used to interpolate drawing
+	EcmReal xprev, yprev;
+
+	// The values below are only used by bodies in the body store
+
+	// Max speed the body can rise or fall at, or 0 if there isn't one
+	float vsp_max;
+
+	// Timestep to move the body with in the next pass, or 0 if it shouldn't be moved
+	float ts;
+
+	// ECM_BODY_* flags for how the body is moved
+	uint8_t flags;
+
+	// ECM_BODY_HIT_* flags for the tiles the body hit in the last pass
+	uint8_t hit;
+
+	// Id of the body
+	EcmBodyId id;
 } EcmBody;
 
-// Checks for an entity body collision with a solid tile
-bool ecm_body_tile_collide(EcmBody *b, double xshift, double yshift);
+// Bodies in the body store, packed together in no particular order
+extern EcmBody *g_ecm_body;
+
+// Index in g_ecm_body of the body with each id
+extern int *g_ecm_body_index;
+
+// Returns a pointer to the body with id id in the body store
+// The pointer is only valid until the next body is added or freed
+#define	ECM_BODY(id)	(&g_ecm_body[g_ecm_body_index[id]])
+
+// Returns true if there's a solid tile right under an entity body shifted horizontally by xshift
+bool ecm_body_tile_below(const EcmBody *b, double xshift);
 
 // Moves an entity body horizontally, returns true if a tile is collided with
 bool ecm_body_move_hori(EcmBody *b);
@@ -34,7 +97,35 @@ bool ecm_body_move_hori(EcmBody *b);
 // Moves an entity body vertically, returns true if a tile is collided with
 bool ecm_body_move_vert(EcmBody *b);
 
+// Adds a copy of body b to the body store and returns its id, returns -1 on error
+EcmBodyId ecm_body_new(const EcmBody *b);
+
+// Frees a body in the body store
+void ecm_body_del(EcmBodyId id);
+
+// Moves every body in the body store with its timestep, then sets the timesteps to 0
+void ecm_body_update_all(void);
+
+// Frees every body in the body store
+void ecm_body_reset(void);
+
+// Frees all memory used by the body store
+void ecm_body_free(void);
+
+// Returns the # of bodies in the body store
+int ecm_body_count(void);
+
+// Returns the # of bytes allocated for the body store
+size_t ecm_body_mem_size(void);
+
+// Stores a body's position as its position on the previous simulation tick
+// This should be called at the start of every update of an entity with a body that isn't in the body store
+#define	ECM_BODY_SAVE_PREV(b)	{ \
+					(b).xprev = (b).x; \
+					(b).yprev = (b).y; \
+				}
+
 // Get rectangle used to check for collisions
-#define	ECM_BODY_GET_CRECT(b)	(SDL_Rect) {b.x, b.y, b.w, b.h}
+#define	ECM_BODY_GET_CRECT(b)	(SDL_Rect) {(b).x, (b).y, (b).w, (b).h}
 
 #endif
@@ -11,7 +11,9 @@
 #include "../camera.h"
 #include "../texture.h"
 #include "../sound.h"
+#include "../timestep.h"
 #include "../collision.h"
+#include "../particle.h"
 #include "../util/rep.h"
 
 #include "c_body.h"
@@ -19,7 +21,6 @@
 #include "c_egg.h"
 
 #include "player.h"
-#include "particle.h"
 #include "fireball.h"
 #include "item.h"		// For dropping items
 #include "ragdoll.h"
@@ -27,7 +28,7 @@
 // Updates an egg's running animation
 void ecm_egg_update_animation(EcmEgg *e)
 {
-	e->spr.anim_tick -= abs((int) e->b.hsp);
+	e->spr.anim_tick -= abs((int) ECM_BODY(e->b)->hsp);
 	if (e->spr.anim_tick <= 0)
 	{
 		e->spr.anim_tick = 7;
@@ -39,24 +40,27 @@ void ecm_egg_update_animation(EcmEgg *e)
 void ecm_egg_draw(EcmEgg *e)
 {
 	const SDL_Rect *srect = &g_spr_egg[e->spr.spr];
-	const SDL_Rect drect = {e->b.x + g_cam.xshift, e->b.y + g_cam.yshift, SPR_EGG_W, SPR_EGG_H};
+	const EcmBody *b = ECM_BODY(e->b);
+	const SDL_Rect drect = {TS_LERP(b->xprev, b->x) + g_cam.xshift, TS_LERP(b->yprev, b->y) + g_cam.yshift, SPR_EGG_W, SPR_EGG_H};
 	SDL_RenderCopyEx(g_renderer, g_tex_egg[e->spr.tex], srect, &drect, 0, NULL, e->spr.flip);
 }
 
-// Spawns bubble particles and an egg ragdoll, should be called before an egg entity is destroyed in its destroy function
+// Spawns bubble particles and an egg ragdoll and frees the egg's body, should be called before an egg entity is destroyed in its destroy function
 void ecm_egg_die(EcmEgg *e)
 {
+	const EcmBody b = *ECM_BODY(e->b);
+	ecm_body_del(e->b);
 	snd_play(snd_splode);
 	REP (6)
-		ent_new_PARTICLE(e->b.x, e->b.y, PTCL_BUBBLE);
-	ent_new_RAGDOLL(e->b.x, e->b.y, e->b.hsp * -1.0, e->b.vsp - 2, e->spr.tex);
+		ptcl_new(b.x, b.y, PTCL_BUBBLE);
+	ent_new_RAGDOLL(b.x, b.y, b.hsp * -1.0, b.vsp - 2, e->spr.tex);
 }
 
 // Handles collisions between the egg and spikes, fireballs, and the player
 // Returns true if the egg dies from any damage it takes
 bool ecm_egg_handle_collisions(EcmEgg *e)
 {
-	SDL_Rect crect = ECM_BODY_GET_CRECT(e->b);
+	SDL_Rect crect = ECM_BODY_GET_CRECT(*ECM_BODY(e->b));
 
 	// Hitting a spike
 	if (check_tile_rect_flags(&crect, TFLAG_SPIKE))
@@ -79,13 +83,14 @@ bool ecm_egg_handle_collisions(EcmEgg *e)
 bool ecm_egg_damage(EcmEgg *e)
 {
 	e->spr.spr = SPR_EGG_FALL;
-	e->spr.anim_tick = abs((int) e->b.hsp * 4);
+	const EcmBody *b = ECM_BODY(e->b);
+	e->spr.anim_tick = abs((int) b->hsp * 4);
 
 	if (--e->hp <= 0)
 		return true;
 
 	snd_play(snd_splode);
 	REP (3)
-		ent_new_PARTICLE(e->b.x, e->b.y, PTCL_BUBBLE);
+		ptcl_new(b->x, b->y, PTCL_BUBBLE);
 	return false;
 }
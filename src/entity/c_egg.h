@@ -11,7 +11,8 @@
 #include "c_sprite.h"
 
 typedef struct{
-	EcmBody b;
+	// Body in the body store
+	EcmBodyId b;
 	EcmEggSpr spr;
 
 	// Hitpoints
@@ -26,7 +27,7 @@ void ecm_egg_update_animation(EcmEgg *e);
 // Draws an egg
 void ecm_egg_draw(EcmEgg *e);
 
-// Spawns bubble particles and an egg ragdoll, should be called before an egg entity is destroyed in its destroy function
+// Spawns bubble particles and an egg ragdoll and frees the egg's body, should be called before an egg entity is destroyed in its destroy function
 void ecm_egg_die(EcmEgg *e);
 
 // Handles collisions between the egg and spikes, fireballs, and the player
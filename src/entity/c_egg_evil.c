@@ -15,7 +15,7 @@
 // Returns true if the evilegg dies from any damage it takes
 bool ecm_egg_evil_handle_collisions(EcmEgg *e)
 {
-	SDL_Rect crect = ECM_BODY_GET_CRECT(e->b);
+	SDL_Rect crect = ECM_BODY_GET_CRECT(*ECM_BODY(e->b));
 
 	// Be damaged by fireballs
 	{
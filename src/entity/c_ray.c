@@ -0,0 +1,41 @@
+/*
+ * c_ray.c contains functions that act on EcmRay structs.
+ */
+
+#include <stdbool.h>
+
+#include "../collision.h"	// For check_tile_ray()
+#include "../tile/data.h"
+#include "c_ray.h"
+
+// Casts a ray for an entity at (x, y) that moves hsp and vsp pixels every tick, looking for tiles with the flags passed
+void ecm_ray_cast(EcmRay *r, float x, float y, float hsp, float vsp, TileFlags flags)
+{
+	const int ticks = check_tile_ray(x, y, hsp, vsp, flags, ECM_RAY_TICKS_MAX);
+	r->ticks = ticks == 0 ? ECM_RAY_TICKS_MAX : ticks < 0 ? 0 : ticks;
+	r->hit = ticks > 0;
+	r->rev = g_tile_map_rev;
+}
+
+// Updates a ray after its entity has moved to (x, y) for the current tick
+// Returns true if the entity is in a tile with the flags passed
+bool ecm_ray_update(EcmRay *r, float x, float y, float hsp, float vsp, TileFlags flags)
+{
+	// The tiles in the entity's path may have changed, so check where it is now and look again
+	if (r->rev != g_tile_map_rev)
+	{
+		if (check_tile_point_flags(x, y, flags))
+			return true;
+		ecm_ray_cast(r, x, y, hsp, vsp, flags);
+		return false;
+	}
+
+	if (r->ticks == 0 || --r->ticks > 0)
+		return false;
+	if (r->hit)
+		return true;
+
+	// The ray ran out before finding a tile, so keep following the path from here
+	ecm_ray_cast(r, x, y, hsp, vsp, flags);
+	return false;
+}
@@ -0,0 +1,38 @@
+/*
+ * c_ray.h contains the EcmRay struct and its associated functions.
+ *
+ * The EcmRay struct is used by entities that move in straight lines at constant speeds (fireballs and evilballs) to find when they'll hit a tile. When one is cast, check_tile_ray() follows the entity's path ahead of time and finds the tick it will first be in a tile with the flags it's looking for. Each tick after that only counts down until that tick comes, without reading the tile map.
+ *
+ * Rays remember the revision of the tile map (g_tile_map_rev in tile/data.h) they were cast with, and are cast again from the entity's current position if the tile map changes.
+ */
+
+#ifndef	ENTITY_C_RAY_H
+#define	ENTITY_C_RAY_H
+
+#include <stdbool.h>
+
+#include "../tile/data.h"	// For TileFlags
+
+// Max # of ticks that a ray follows an entity's path for, it's cast again from where it stopped if the entity gets that far
+#define	ECM_RAY_TICKS_MAX	600
+
+typedef struct{
+	// Ticks left until the entity is in a tile, or until the ray should be cast again if hit is false
+	// 0 if the entity will never be in a tile
+	int ticks;
+
+	// True if the entity is in a tile when ticks runs out
+	bool hit;
+
+	// g_tile_map_rev when the ray was cast
+	unsigned int rev;
+} EcmRay;
+
+// Casts a ray for an entity at (x, y) that moves hsp and vsp pixels every tick, looking for tiles with the flags passed
+void ecm_ray_cast(EcmRay *r, float x, float y, float hsp, float vsp, TileFlags flags);
+
+// Updates a ray after its entity has moved to (x, y) for the current tick
+// Returns true if the entity is in a tile with the flags passed
+bool ecm_ray_update(EcmRay *r, float x, float y, float hsp, float vsp, TileFlags flags);
+
+#endif
@@ -7,6 +7,8 @@
 
 #include <SDL2/SDL.h>
 
+#include "c_base.h"	// For ENT_COMPACT_BITS()
+
 // Spritesheet access
 #define	SPR_EGG_W	32
 #define	SPR_EGG_H	32
@@ -64,7 +66,7 @@ extern SDL_Texture **const g_tex_egg;
 typedef struct{
 	SprEgg spr : 4;
 	TexEgg tex : 2;
-	SDL_RendererFlip flip;
+	SDL_RendererFlip flip ENT_COMPACT_BITS(2);
 
 	// Used to store relative # of frames before the next animation frame is displayed
 	short anim_tick;
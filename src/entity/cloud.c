@@ -19,6 +19,9 @@
 // Clouds per square pixel of screen size
 #define	CLOUDS_PER_PIXEL	0.00016
 
+// Maximum # of clouds
+#define	CLOUD_COUNT_MAX		160
+
 // Maximum width and height a cloud sprite can have in pixels
 #define	CLOUD_MAX_WIDTH		110
 #define	CLOUD_MAX_HEIGHT	50
@@ -30,13 +33,12 @@
 //	a new map is loaded
 void ent_cloud_scatter(void)
 {
-	EntCLOUD *e = g_er[ENT_ID_CLOUD]->e;
 	for (int i = 0; i < g_er[ENT_ID_CLOUD]->len; i++)
 	{
+		EntCLOUD *e = ENT_ARRAY_AT(g_er[ENT_ID_CLOUD], i);
 		e->x = -g_cam.xshift + (float) spdl_random() / 255.0f * g_screen_width;
 		e->y = -g_cam.yshift + (float) spdl_random() / 255.0f * g_screen_height;
 		e->hsp = ENT_CLOUD_GET_RANDOM_HSP();
-		e++;
 	}
 }
 
@@ -46,9 +48,23 @@ void ent_cloud_update_count(void)
 	int cloud_count = clamp(
 		CLOUDS_PER_PIXEL * (g_screen_width * g_screen_height),
 		0,
-		g_er[ENT_ID_CLOUD]->len_max
+		CLOUD_COUNT_MAX
 	);
-	g_er[ENT_ID_CLOUD]->len = cloud_count;
+
+	// Add or remove clouds at the end of the array
+	// Clouds are scattered right after, so new clouds don't need to be set up here
+	EntArray *a = g_er[ENT_ID_CLOUD];
+	while (a->len < cloud_count)
+	{
+		EntCLOUD *e;
+		if ((e = ent_array_add(a)) == NULL)
+			break;
+		e->base.status = ENT_STAT_NORM;
+		e->base.id = ENT_ID_CLOUD;
+	}
+	while (a->len > cloud_count)
+		ent_array_del(ENT_ID_CLOUD, a->len - 1);
+
 	ent_cloud_scatter();
 }
 
@@ -103,11 +119,11 @@ void ent_draw_CLOUD(EntCLOUD *e)
 		srect = (SDL_Rect) {0, 0, 102, 50};
 	else
 		srect = (SDL_Rect) {103, 0, 42, 23};
-	SDL_Rect drect = {e->x + g_cam.xshift, e->y + g_cam.yshift, srect.w, srect.h};
+	SDL_Rect drect = {TS_LERP_SPD(e->x, e->hsp) + g_cam.xshift, e->y + g_cam.yshift, srect.w, srect.h};
 	SDL_RenderCopy(g_renderer, tex_cloud, &srect, &drect);
 }
 
 void ent_destroy_CLOUD(EntCLOUD *e)
 {
-	ENT_DEL(e);
+	ENT_DEL_MARK(e);
 }
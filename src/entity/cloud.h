@@ -33,6 +33,9 @@ typedef struct{
 	EntCloudId id;
 } EntCLOUD;
 
+// Rectangle in the game world that a cloud is drawn in, big enough for big clouds
+#define	ENT_BOUNDS_CLOUD(ent)	((SDL_Rect) {(ent)->x, (ent)->y, 102, 50})
+
 // Scatters the clouds randomly across the screen
 // This should be called when...
 // 	the game starts
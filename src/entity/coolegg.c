@@ -19,7 +19,11 @@
 EntCOOLEGG *ent_new_COOLEGG(int x, int y)
 {
 	ENT_NEW(COOLEGG);
-	e->e.b = (EcmBody) {x, y, 31, 31, 4, 0, 0.075};
+	if ((e->e.b = ecm_body_new(&(EcmBody) {.x = x, .y = y, .w = 31, .h = 31, .hsp = 4, .grv = 0.075, .xprev = x, .yprev = y})) == -1)
+	{
+		ENT_DEL_MARK(e);
+		return NULL;
+	}
 	e->e.spr = (EcmEggSpr) {SPR_EGG_IDLE, TEX_EGG_COOL, SDL_FLIP_NONE, 0};
 	e->e.hp = 8;
 	return e;
@@ -28,22 +32,26 @@ EntCOOLEGG *ent_new_COOLEGG(int x, int y)
 void ent_update_COOLEGG(EntCOOLEGG *e)
 {
 	static int tick = 0;
+	EcmBody *b = ECM_BODY(e->e.b);
+
+	// Stop at tiles
+	if (b->hit & ECM_BODY_HIT_HORI)
+		b->hsp = 0;
+	if (b->hit & ECM_BODY_HIT_VERT)
+		b->vsp = 0;
+
 	if (--tick <= 0)
 	{
-		e->e.b.hsp = ((spdl_random() - 128) / 128.0f) * 10;
-		e->e.b.vsp = -(spdl_random()/ 255.0f) * 6;
+		b->hsp = ((spdl_random() - 128) / 128.0f) * 10;
+		b->vsp = -(spdl_random()/ 255.0f) * 6;
 		tick = 35 + (spdl_random() / 255.0f) * 70;
 	}
-	e->e.b.hsp *= 0.97;
-	if (fabs(e->e.b.hsp) < 0.5f)
+	b->hsp *= 0.97;
+	if (fabs(b->hsp) < 0.5f)
 		e->e.spr.spr = SPR_EGG_IDLE;
-	e->e.spr.flip = e->e.b.hsp > 0 ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
+	e->e.spr.flip = b->hsp > 0 ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
+	b->ts = g_ts;
 
-	if (ecm_body_move_hori(&e->e.b))
-		e->e.b.hsp = 0;
-	e->e.b.vsp += e->e.b.grv * g_ts;
-	if (ecm_body_move_vert(&e->e.b))
-		e->e.b.vsp = 0;
 	ecm_egg_update_animation(&e->e);
 	if (ecm_egg_handle_collisions(&e->e))
 		ent_destroy_COOLEGG(e);
@@ -17,6 +17,9 @@ typedef struct{
 	EcmEgg e;
 } EntCOOLEGG;
 
+// Rectangle in the game world that a cool egg is drawn in
+#define	ENT_BOUNDS_COOLEGG(ent)	((SDL_Rect) {ECM_BODY((ent)->e.b)->x, ECM_BODY((ent)->e.b)->y, SPR_EGG_W, SPR_EGG_H})
+
 EntCOOLEGG *ent_new_COOLEGG(int x, int y);
 void ent_update_COOLEGG(EntCOOLEGG *e);
 void ent_draw_COOLEGG(EntCOOLEGG *e);
@@ -30,7 +30,7 @@ EntDOOR *ent_new_DOOR(int x, int y, EntDoorId did)
 {
 	assert(ENT_DOOR_ID_IS_VALID(did));
 	ENT_NEW(DOOR);
-	e->b = (EcmBody) {x, y, TILE_SIZE, TILE_SIZE, 0, 0, 0};
+	e->b = (EcmBody) {.x = x, .y = y, .w = TILE_SIZE, .h = TILE_SIZE, .xprev = x, .yprev = y};
 	e->did = did;
 	return e;
 }
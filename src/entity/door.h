@@ -16,6 +16,7 @@
 #include "entity.h"
 
 #include "../map.h"	// For MAP_PATH_MAX
+#include "../tile/data.h"	// For TILE_SIZE
 
 // The maximum number of doors in a map
 // Valid door ids must be in the range [0, ENT_DOOR_MAX)
@@ -38,6 +39,9 @@ typedef struct{
 	EntDoorId did;
 } EntDOOR;
 
+// Rectangle in the game world that a door is drawn in
+#define	ENT_BOUNDS_DOOR(ent)	((SDL_Rect) {(ent)->b.x, (ent)->b.y, TILE_SIZE, TILE_SIZE})
+
 // Array of paths to map files that doors lead to, indexed by EntDoorIds
 extern char g_ent_door_map_path[ENT_DOOR_MAX][ENT_DOOR_MAP_PATH_MAX];
 
@@ -11,19 +11,20 @@
 #include "array.h"
 #include "root.h"
 #include "c_base.h"
+#include "grid.h"
+#include "spawn.h"
 
 // Shorthand for creating a pointer to an entity named e
+// The entity is put in its type's spawn queue if spawns are being queued (see spawn.h)
 #define	ENT_NEW(name)	Ent##name *e; \
-			if ((e = ent_array_add(g_er[ENT_ID_##name])) == NULL) \
+			if ((e = ent_spawn_add(ENT_ID_##name)) == NULL) \
 				return NULL; \
 			e->base.status = ENT_STAT_NORM; \
 			e->base.id = ENT_ID_##name; \
-			e->base.index = g_er[ENT_ID_##name]->len - 1
-
-// Shorthand for deleting an entity
-#define	ENT_DEL(e)	ent_array_del(e->base.id, e->base.index)
+			e->base.lod_ts = 0.0f
 
 // Shorthand for marking an entity for deletion, but not actually deleting it yet
+// Entities are always deleted this way, so that deleting an entity never moves other entities while they're being updated
 #define	ENT_DEL_MARK(e)	e->base.status = ENT_STAT_DEL; \
 			g_er[e->base.id]->status = ENT_ARRAY_CLEAN
 
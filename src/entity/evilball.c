@@ -8,12 +8,16 @@
 #include "../timestep.h"
 #include "../util/rep.h"
 #include "../collision.h"
+#include "../job.h"
+#include "../particle.h"
 
 #include "entity.h"
 
-#include "particle.h"
 #include "evilball.h"
 
+// Destroys an evilball, for destroying evilballs from jobs
+static void ent_evilball_destroy_cmd(void *e);
+
 EntEVILBALL *ent_new_EVILBALL(int x, int y, float hsp, float vsp)
 {
 	ENT_NEW(EVILBALL);
@@ -21,6 +25,7 @@ EntEVILBALL *ent_new_EVILBALL(int x, int y, float hsp, float vsp)
 	e->y = y;
 	e->hsp = hsp;
 	e->vsp = vsp;
+	ecm_ray_cast(&e->ray, e->x, e->y, e->hsp, e->vsp, TFLAG_EVILSTOP);
 	e->destroy_ticks = 300.0f;
 	return e;
 }
@@ -30,9 +35,9 @@ void ent_update_EVILBALL(EntEVILBALL *e)
 	e->x += e->hsp * g_ts;
 	e->y += e->vsp * g_ts;
 	if ((e->destroy_ticks -= g_ts) <= 0.0f)
-		ent_destroy_EVILBALL(e);
-	else if (g_tile_md[check_tile_point(e->x, e->y)].flags & TFLAG_EVILSTOP)
-		ent_destroy_EVILBALL(e);
+		job_cmd(ent_evilball_destroy_cmd, e);
+	else if (ecm_ray_update(&e->ray, e->x, e->y, e->hsp, e->vsp, TFLAG_EVILSTOP))
+		job_cmd(ent_evilball_destroy_cmd, e);
 }
 
 void ent_draw_EVILBALL(EntEVILBALL *e)
@@ -52,8 +57,8 @@ void ent_draw_EVILBALL(EntEVILBALL *e)
 
 	// Render evilball
 	SDL_Rect drect = {
-		e->x - 8 + g_cam.xshift,
-		e->y - 8 + g_cam.yshift,
+		TS_LERP_SPD(e->x, e->hsp) - 8 + g_cam.xshift,
+		TS_LERP_SPD(e->y, e->vsp) - 8 + g_cam.yshift,
 		16,
 		16
 	};
@@ -64,6 +69,12 @@ void ent_draw_EVILBALL(EntEVILBALL *e)
 void ent_destroy_EVILBALL(EntEVILBALL *e)
 {
 	REP (4)
-		ent_new_PARTICLE(e->x, e->y, PTCL_BUBBLE);
+		ptcl_new(e->x, e->y, PTCL_BUBBLE);
 	ENT_DEL_MARK(e);
 }
+
+// Destroys an evilball, for destroying evilballs from jobs
+static void ent_evilball_destroy_cmd(void *e)
+{
+	ent_destroy_EVILBALL(e);
+}
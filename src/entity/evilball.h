@@ -7,6 +7,7 @@
 #ifndef	ENTITY_EVILBALL_H
 #define	ENTITY_EVILBALL_H
 
+#include "c_ray.h"
 #include "entity.h"
 
 // Entity item type
@@ -21,6 +22,9 @@ typedef struct{
 	float hsp;
 	float vsp;
 
+	// Finds when the evilball reaches an evilstop tile
+	EcmRay ray;
+
 	// Stores 0 or 1 to indicate which fireball sprite to render
 	unsigned int frame : 1;
 
@@ -31,6 +35,9 @@ typedef struct{
 	float destroy_ticks;
 } EntEVILBALL;
 
+// Rectangle in the game world that an evilball is drawn in
+#define	ENT_BOUNDS_EVILBALL(ent)	((SDL_Rect) {(ent)->x - 8, (ent)->y - 8, 16, 16})
+
 EntEVILBALL *ent_new_EVILBALL(int x, int y, float hsp, float vsp);
 void ent_update_EVILBALL(EntEVILBALL *e);
 void ent_draw_EVILBALL(EntEVILBALL *e);
@@ -11,10 +11,14 @@
 #include "../texture.h"
 #include "../camera.h"
 #include "../collision.h"
+#include "../job.h"
+#include "../particle.h"
 #include "entity.h"
-#include "particle.h"
 #include "fireball.h"
 
+// Destroys a fireball, for destroying fireballs from jobs
+static void ent_fireball_destroy_cmd(void *e);
+
 EntFIREBALL *ent_new_FIREBALL(int x, int y, float hsp, float vsp)
 {
 	ENT_NEW(FIREBALL);
@@ -22,6 +26,7 @@ EntFIREBALL *ent_new_FIREBALL(int x, int y, float hsp, float vsp)
 	e->y = y;
 	e->hsp = hsp;
 	e->vsp = vsp;
+	ecm_ray_cast(&e->ray, e->x, e->y, e->hsp, e->vsp, TFLAG_SOLID);
 	return e;
 }
 
@@ -29,8 +34,8 @@ void ent_update_FIREBALL(EntFIREBALL *e)
 {
 	e->x += e->hsp * g_ts;
 	e->y += e->vsp * g_ts;
-	if (g_tile_md[check_tile_point(e->x, e->y)].flags & TFLAG_SOLID)
-		ent_destroy_FIREBALL(e);
+	if (ecm_ray_update(&e->ray, e->x, e->y, e->hsp, e->vsp, TFLAG_SOLID))
+		job_cmd(ent_fireball_destroy_cmd, e);
 }
 
 void ent_draw_FIREBALL(EntFIREBALL *e)
@@ -50,8 +55,8 @@ void ent_draw_FIREBALL(EntFIREBALL *e)
 
 	// Render fireball
 	SDL_Rect drect = {
-		e->x - 8 + g_cam.xshift,
-		e->y - 8 + g_cam.yshift,
+		TS_LERP_SPD(e->x, e->hsp) - 8 + g_cam.xshift,
+		TS_LERP_SPD(e->y, e->vsp) - 8 + g_cam.yshift,
 		16,
 		16,
 	};
@@ -60,6 +65,12 @@ void ent_draw_FIREBALL(EntFIREBALL *e)
 
 void ent_destroy_FIREBALL(EntFIREBALL *e)
 {
-	ent_new_PARTICLE(e->x, e->y, PTCL_FLAME);
+	ptcl_new(e->x, e->y, PTCL_FLAME);
 	ENT_DEL_MARK(e);
 }
+
+// Destroys a fireball, for destroying fireballs from jobs
+static void ent_fireball_destroy_cmd(void *e)
+{
+	ent_destroy_FIREBALL(e);
+}
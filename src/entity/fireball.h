@@ -7,6 +7,7 @@
 #ifndef	ENTITY_FIREBALL_H
 #define	ENTITY_FIREBALL_H
 
+#include "c_ray.h"
 #include "entity.h"
 
 // Entity fireball type
@@ -21,6 +22,9 @@ typedef struct{
 	float hsp;
 	float vsp;
 
+	// Finds when the fireball reaches a solid tile
+	EcmRay ray;
+
 	// Stores 0 or 1 to indicate which fireball sprite to render
 	unsigned int frame : 1;
 
@@ -28,6 +32,9 @@ typedef struct{
 	unsigned int frame_tmr : 2;
 } EntFIREBALL;
 
+// Rectangle in the game world that a fireball is drawn in
+#define	ENT_BOUNDS_FIREBALL(ent)	((SDL_Rect) {(ent)->x - 8, (ent)->y - 8, 16, 16})
+
 EntFIREBALL *ent_new_FIREBALL(int x, int y, float hsp, float vsp);
 void ent_update_FIREBALL(EntFIREBALL *e);
 void ent_draw_FIREBALL(EntFIREBALL *e);
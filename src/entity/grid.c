@@ -0,0 +1,329 @@
+/*
+ * grid.c contains spatial hash grids for finding entities that overlap rectangles.
+ */
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>	// For memset()
+
+#include <SDL2/SDL.h>
+
+#include "../collision.h"	// For check_rect()
+#include "../error.h"
+#include "entity.h"
+#include "evilball.h"
+#include "fireball.h"
+#include "grid.h"
+#include "item.h"
+
+// An entity in a grid
+typedef struct{
+	// Index of the entity in its entity array
+	int index;
+
+	// Position of the top left corner of the entity's rectangle
+	int x;
+	int y;
+
+	// Bucket the entity is in
+	int bucket;
+} EntGridEnt;
+
+// Spatial hash grid type
+typedef struct{
+	// True if the grid needs to be rebuilt before it's searched
+	bool dirty;
+
+	// Entities in the grid in the order of their entity array
+	EntGridEnt *ent;
+
+	// Entities in the grid sorted by bucket
+	EntGridEnt *bucket_ent;
+
+	// # of entities in the grid and # of entities there's room for
+	int len;
+	int len_max;
+
+	// Index in bucket_ent of the first entity of each bucket, followed by len
+	int bucket[ENT_GRID_BUCKETS + 1];
+} EntGrid;
+
+static EntGrid g_ent_grid_item = {.dirty = true};
+static EntGrid g_ent_grid_fireball = {.dirty = true};
+static EntGrid g_ent_grid_evilball = {.dirty = true};
+
+// Grid of each entity type, or NULL for types that don't have one
+static EntGrid *const g_ent_grid[ENT_MAX] = {
+	[ENT_ID_ITEM] = &g_ent_grid_item,
+	[ENT_ID_FIREBALL] = &g_ent_grid_fireball,
+	[ENT_ID_EVILBALL] = &g_ent_grid_evilball,
+};
+
+// Returns the grid of an entity type after rebuilding it if it's dirty, or NULL if the type doesn't have a grid or rebuilding it failed
+static EntGrid *ent_grid_get(EntId id);
+
+// Rebuilds a grid from its entity array, returns nonzero on error
+static int ent_grid_build(EntId id, EntGrid *g);
+
+// Finds the buckets that entities overlapping rect can be in, with no bucket listed twice
+// Returns the # of buckets, or -1 if rect covers more than ENT_GRID_SEARCH_CELLS_MAX cells
+static int ent_grid_buckets(const SDL_Rect *rect, int *bucket);
+
+// Returns true if an entity in a grid overlaps with rect and isn't marked for deletion
+static bool ent_grid_match(EntId id, const EntGridEnt *ge, const SDL_Rect *rect);
+
+// Gets the position of the top left corner of an entity's rectangle
+static void ent_grid_pos(EntId id, const void *e, int *x, int *y);
+
+// Returns the cell that a position is in on one axis
+static int ent_grid_cell(int pos);
+
+// Returns the bucket of a cell
+static int ent_grid_hash(int cx, int cy);
+
+// Marks the grid of an entity type as out of date, does nothing for types without a grid
+void ent_grid_dirty(EntId id)
+{
+	if (g_ent_grid[id] != NULL)
+		g_ent_grid[id]->dirty = true;
+}
+
+// Returns a pointer to the first entity of a type in its entity array that overlaps with rect and isn't marked for deletion, or NULL if there isn't one
+void *ent_grid_first(EntId id, const SDL_Rect *rect)
+{
+	EntGrid *g;
+	if ((g = ent_grid_get(id)) == NULL)
+		return NULL;
+
+	int bucket[ENT_GRID_SEARCH_CELLS_MAX];
+	const int bucket_len = ent_grid_buckets(rect, bucket);
+	if (bucket_len == -1)
+	{
+		// Entities are checked in order, so the first match is the first entity
+		for (int i = 0; i < g->len; i++)
+			if (ent_grid_match(id, &g->ent[i], rect))
+				return ENT_ARRAY_AT(g_er[id], g->ent[i].index);
+		return NULL;
+	}
+
+	// Entities are in order within each bucket, so each bucket is only searched until an entity after the first match so far is reached
+	int first = INT_MAX;
+	for (int i = 0; i < bucket_len; i++)
+	{
+		for (int j = g->bucket[bucket[i]]; j < g->bucket[bucket[i] + 1]; j++)
+		{
+			const EntGridEnt *ge = &g->bucket_ent[j];
+			if (ge->index >= first)
+				break;
+			if (ent_grid_match(id, ge, rect))
+			{
+				first = ge->index;
+				break;
+			}
+		}
+	}
+	return first == INT_MAX ? NULL : ENT_ARRAY_AT(g_er[id], first);
+}
+
+// Finds all entities of a type that overlap with rect and aren't marked for deletion, in no particular order
+// Pointers to up to ent_len of them are stored in ent
+// Returns the # of entities found, which can be more than ent_len
+int ent_grid_all(EntId id, const SDL_Rect *rect, void **ent, int ent_len)
+{
+	EntGrid *g;
+	if ((g = ent_grid_get(id)) == NULL)
+		return 0;
+
+	int len = 0;
+	int bucket[ENT_GRID_SEARCH_CELLS_MAX];
+	const int bucket_len = ent_grid_buckets(rect, bucket);
+	if (bucket_len == -1)
+	{
+		for (int i = 0; i < g->len; i++)
+			if (ent_grid_match(id, &g->ent[i], rect) && len++ < ent_len)
+				ent[len - 1] = ENT_ARRAY_AT(g_er[id], g->ent[i].index);
+		return len;
+	}
+
+	for (int i = 0; i < bucket_len; i++)
+		for (int j = g->bucket[bucket[i]]; j < g->bucket[bucket[i] + 1]; j++)
+			if (ent_grid_match(id, &g->bucket_ent[j], rect) && len++ < ent_len)
+				ent[len - 1] = ENT_ARRAY_AT(g_er[id], g->bucket_ent[j].index);
+	return len;
+}
+
+// Frees all grids
+void ent_grid_free(void)
+{
+	for (int i = 0; i < ENT_MAX; i++)
+	{
+		EntGrid *g = g_ent_grid[i];
+		if (g == NULL)
+			continue;
+		free(g->ent);
+		free(g->bucket_ent);
+		g->ent = NULL;
+		g->bucket_ent = NULL;
+		g->len = 0;
+		g->len_max = 0;
+		g->dirty = true;
+	}
+}
+
+// Returns the grid of an entity type after rebuilding it if it's dirty, or NULL if the type doesn't have a grid or rebuilding it failed
+static EntGrid *ent_grid_get(EntId id)
+{
+	EntGrid *g = g_ent_grid[id];
+	if (g == NULL)
+	{
+		PERR("entity type %d doesn't have a grid", (int) id);
+		return NULL;
+	}
+	if (g->dirty)
+	{
+		if (ent_grid_build(id, g))
+			return NULL;
+		g->dirty = false;
+	}
+	return g;
+}
+
+// Rebuilds a grid from its entity array, returns nonzero on error
+static int ent_grid_build(EntId id, EntGrid *g)
+{
+	const EntArray *a = g_er[id];
+
+	// Make room for every entity in the array
+	if (a->len > g->len_max)
+	{
+		int len_max = g->len_max == 0 ? ENT_CHUNK_LEN : g->len_max;
+		while (len_max < a->len)
+			len_max *= 2;
+		EntGridEnt *ent = realloc(g->ent, len_max * sizeof(EntGridEnt));
+		if (ent == NULL)
+		{
+			PERR("failed to allocate mem for entity grid");
+			return 1;
+		}
+		g->ent = ent;
+		EntGridEnt *bucket_ent = realloc(g->bucket_ent, len_max * sizeof(EntGridEnt));
+		if (bucket_ent == NULL)
+		{
+			PERR("failed to allocate mem for entity grid");
+			return 1;
+		}
+		g->bucket_ent = bucket_ent;
+		g->len_max = len_max;
+	}
+
+	// Find the bucket of each entity and count the entities in each bucket
+	memset(g->bucket, 0, sizeof(g->bucket));
+	g->len = 0;
+	for (int i = 0; i < a->len; i++)
+	{
+		const void *e = ENT_ARRAY_AT(a, i);
+		if (((const EcmBase *) e)->status == ENT_STAT_DEL)
+			continue;
+
+		EntGridEnt *ge = &g->ent[g->len++];
+		ge->index = i;
+		ent_grid_pos(id, e, &ge->x, &ge->y);
+		ge->bucket = ent_grid_hash(ent_grid_cell(ge->x + ENT_GRID_ENT_SIZE / 2), ent_grid_cell(ge->y + ENT_GRID_ENT_SIZE / 2));
+		g->bucket[ge->bucket]++;
+	}
+
+	// Turn the counts into the index of the first entity of each bucket
+	int start = 0;
+	for (int i = 0; i < ENT_GRID_BUCKETS; i++)
+	{
+		const int len = g->bucket[i];
+		g->bucket[i] = start;
+		start += len;
+	}
+	g->bucket[ENT_GRID_BUCKETS] = g->len;
+
+	// Put the entities in their buckets in order, using the start of each bucket as where its next entity goes
+	// This leaves the start of each bucket at the start of the next one, so they're shifted back after
+	for (int i = 0; i < g->len; i++)
+		g->bucket_ent[g->bucket[g->ent[i].bucket]++] = g->ent[i];
+	for (int i = ENT_GRID_BUCKETS - 1; i > 0; i--)
+		g->bucket[i] = g->bucket[i - 1];
+	g->bucket[0] = 0;
+	return 0;
+}
+
+// Finds the buckets that entities overlapping rect can be in, with no bucket listed twice
+// Returns the # of buckets, or -1 if rect covers more than ENT_GRID_SEARCH_CELLS_MAX cells
+static int ent_grid_buckets(const SDL_Rect *rect, int *bucket)
+{
+	// An entity overlaps with rect if its center is less than half of its size outside of rect
+	const int cx1 = ent_grid_cell(rect->x - ENT_GRID_ENT_SIZE / 2);
+	const int cy1 = ent_grid_cell(rect->y - ENT_GRID_ENT_SIZE / 2);
+	const int cx2 = ent_grid_cell(rect->x + rect->w + ENT_GRID_ENT_SIZE / 2);
+	const int cy2 = ent_grid_cell(rect->y + rect->h + ENT_GRID_ENT_SIZE / 2);
+	if ((long) (cx2 - cx1 + 1) * (cy2 - cy1 + 1) > ENT_GRID_SEARCH_CELLS_MAX)
+		return -1;
+
+	int len = 0;
+	for (int cy = cy1; cy <= cy2; cy++)
+	{
+		for (int cx = cx1; cx <= cx2; cx++)
+		{
+			// Different cells can hash to the same bucket
+			const int b = ent_grid_hash(cx, cy);
+			int i = 0;
+			while (i < len && bucket[i] != b)
+				i++;
+			if (i == len)
+				bucket[len++] = b;
+		}
+	}
+	return len;
+}
+
+// Returns true if an entity in a grid overlaps with rect and isn't marked for deletion
+static bool ent_grid_match(EntId id, const EntGridEnt *ge, const SDL_Rect *rect)
+{
+	const SDL_Rect erect = {ge->x, ge->y, ENT_GRID_ENT_SIZE, ENT_GRID_ENT_SIZE};
+
+	// Entities can be marked for deletion after the grid is built
+	return check_rect(&erect, rect) && ((const EcmBase *) ENT_ARRAY_AT(g_er[id], ge->index))->status != ENT_STAT_DEL;
+}
+
+// Gets the position of the top left corner of an entity's rectangle
+static void ent_grid_pos(EntId id, const void *e, int *x, int *y)
+{
+	switch (id)
+	{
+	case ENT_ID_ITEM:
+		*x = ((const EntITEM *) e)->x - ENT_GRID_ENT_SIZE / 2;
+		*y = ((const EntITEM *) e)->y - ENT_GRID_ENT_SIZE / 2;
+		break;
+	case ENT_ID_FIREBALL:
+		*x = ((const EntFIREBALL *) e)->x - ENT_GRID_ENT_SIZE / 2;
+		*y = ((const EntFIREBALL *) e)->y - ENT_GRID_ENT_SIZE / 2;
+		break;
+	case ENT_ID_EVILBALL:
+		*x = ((const EntEVILBALL *) e)->x - ENT_GRID_ENT_SIZE / 2;
+		*y = ((const EntEVILBALL *) e)->y - ENT_GRID_ENT_SIZE / 2;
+		break;
+	default:
+		*x = 0;
+		*y = 0;
+		PERR("entity type %d doesn't have a grid", (int) id);
+	}
+}
+
+// Returns the cell that a position is in on one axis
+static int ent_grid_cell(int pos)
+{
+	// Round down for negative positions too
+	return pos >= 0 ? pos / ENT_GRID_CELL_SIZE : (pos + 1) / ENT_GRID_CELL_SIZE - 1;
+}
+
+// Returns the bucket of a cell
+static int ent_grid_hash(int cx, int cy)
+{
+	return ((unsigned int) cx * 73856093u ^ (unsigned int) cy * 19349663u) & (ENT_GRID_BUCKETS - 1);
+}
@@ -0,0 +1,42 @@
+/*
+ * grid.h contains spatial hash grids for finding entities that overlap rectangles.
+ *
+ * Items, fireballs and evilballs each have a grid. The world is split into square cells of ENT_GRID_CELL_SIZE pixels, and each cell is hashed into one of ENT_GRID_BUCKETS buckets, so the grid takes up the same amount of memory no matter how big the map is. An entity is put in the bucket of the cell that its center is in. Entities in each bucket are stored packed together in one array, in the order they're in in their entity array.
+ *
+ * A grid is rebuilt the next time it's searched after it's marked as dirty. Adding entities to an entity array marks its grid, ent_clean_all() and ent_destroy_temp() mark the grids of arrays they change, and sim_update() marks the grids of entity types that move after updating them.
+ */
+
+#ifndef	ENTITY_GRID_H
+#define	ENTITY_GRID_H
+
+#include <SDL2/SDL.h>
+
+#include "id.h"
+
+// Width and height of a grid cell in pixels (2 tiles)
+#define	ENT_GRID_CELL_SIZE	64
+
+// # of buckets in a grid (must be a power of 2)
+#define	ENT_GRID_BUCKETS	4096
+
+// Width and height of the entities in grids, which have their position at their center
+#define	ENT_GRID_ENT_SIZE	16
+
+// Max # of cells a search looks in before it checks every entity instead
+#define	ENT_GRID_SEARCH_CELLS_MAX	16
+
+// Marks the grid of an entity type as out of date, does nothing for types without a grid
+void ent_grid_dirty(EntId id);
+
+// Returns a pointer to the first entity of a type in its entity array that overlaps with rect and isn't marked for deletion, or NULL if there isn't one
+void *ent_grid_first(EntId id, const SDL_Rect *rect);
+
+// Finds all entities of a type that overlap with rect and aren't marked for deletion, in no particular order
+// Pointers to up to ent_len of them are stored in ent
+// Returns the # of entities found, which can be more than ent_len
+int ent_grid_all(EntId id, const SDL_Rect *rect, void **ent, int ent_len);
+
+// Frees all grids
+void ent_grid_free(void);
+
+#endif
@@ -20,45 +20,43 @@
 EntGROUNDGUY *ent_new_GROUNDGUY(int x, int y, float hsp, float jsp, bool stay_on_ledge, BarrierTag btag)
 {
 	ENT_NEW(GROUNDGUY);
-	e->e.b = (EcmBody) {x, y, 31, 31, hsp, 0, 0.05*2};
+	if ((e->e.b = ecm_body_new(&(EcmBody) {.x = x, .y = y, .w = 31, .h = 31, .hsp = hsp, .grv = 0.05*2, .xprev = x, .yprev = y, .flags = stay_on_ledge ? ECM_BODY_LEDGES : 0})) == -1)
+	{
+		ENT_DEL_MARK(e);
+		return NULL;
+	}
 	e->e.spr = (EcmEggSpr) {SPR_EGG_IDLE, TEX_EGG_EVIL, SDL_FLIP_NONE, 0};
 	e->e.hp = 4;
 	e->jsp = jsp;
 	e->stay_on_ledge = stay_on_ledge;
 	e->btag = btag;
+	barrier_add_carrier(btag);
 	PINF("groundguy with btag %d created", (int) btag);
 	return e;
 }
 
 void ent_update_GROUNDGUY(EntGROUNDGUY *e)
 {
-	// Movement
-	if (ecm_body_move_hori(&e->e.b))
-	{
-		// Changing movement direction
-		if (signf(e->e.b.hsp *= -1) == 1)
-			e->e.spr.flip = SDL_FLIP_NONE;
-		else
-			e->e.spr.flip = SDL_FLIP_HORIZONTAL;
-	}
-	else if (e->stay_on_ledge && !ecm_body_tile_collide(&e->e.b, e->e.b.hsp * g_ts, 1))
+	EcmBody *b = ECM_BODY(e->e.b);
+
+	// Turn around at walls, and at ledges if the egg stays on them
+	if (b->hit & (ECM_BODY_HIT_HORI | ECM_BODY_HIT_LEDGE))
 	{
-		// Don't walk off of ledges
 		// Changing movement direction
-		if (signf(e->e.b.hsp *= -1) == 1)
+		if (signf(b->hsp *= -1) == 1)
 			e->e.spr.flip = SDL_FLIP_NONE;
 		else
 			e->e.spr.flip = SDL_FLIP_HORIZONTAL;
 	}
-	e->e.b.vsp += e->e.b.grv * g_ts;
-	if (ecm_body_move_vert(&e->e.b))
+	if (b->hit & ECM_BODY_HIT_VERT)
 	{
 		// Jump when the ground is hit
-		if (e->e.b.vsp >= 0)
-			e->e.b.vsp = e->jsp;
+		if (b->vsp >= 0)
+			b->vsp = e->jsp;
 		else
-			e->e.b.vsp = 0;
+			b->vsp = 0;
 	}
+	b->ts = g_ts;
 	
 	ecm_egg_update_animation(&e->e);
 	if (ecm_egg_evil_handle_collisions(&e->e))
@@ -72,7 +70,7 @@ void ent_draw_GROUNDGUY(EntGROUNDGUY *e)
 
 void ent_destroy_GROUNDGUY(EntGROUNDGUY *e)
 {
-	barrier_send_check_request(e->btag);
+	barrier_remove_carrier(e->btag);
 	ecm_egg_die(&e->e);
 	ENT_DEL_MARK(e);
 }
@@ -8,6 +8,7 @@
 #define	ENTITY_GROUNDGUY_H
 
 #include "../barrier.h"
+#include "../tile/data.h"	// For TILE_SIZE
 
 #include "c_egg.h"
 #include "entity.h"
@@ -26,6 +27,13 @@ typedef struct{
 	BarrierTag btag;
 } EntGROUNDGUY;
 
+// Rectangle in the game world that a groundguy is drawn in
+#define	ENT_BOUNDS_GROUNDGUY(ent)	((SDL_Rect) {ECM_BODY((ent)->e.b)->x, ECM_BODY((ent)->e.b)->y, SPR_EGG_W, SPR_EGG_H})
+
+// Distances from the screen that groundguys are updated less often and put to sleep at (see ENT_UPDATE_LOD() in all.h)
+#define	ENT_LOD_NEAR_GROUNDGUY	(TILE_SIZE * 4)
+#define	ENT_LOD_FAR_GROUNDGUY	(TILE_SIZE * 16)
+
 EntGROUNDGUY *ent_new_GROUNDGUY(int x, int y, float hsp, float jsp, bool stay_on_ledge, BarrierTag btag);
 void ent_update_GROUNDGUY(EntGROUNDGUY *e);
 void ent_draw_GROUNDGUY(EntGROUNDGUY *e);
@@ -10,7 +10,6 @@ typedef enum{
 	ENT_ID_PLAYER,
 	ENT_ID_ITEM,
 	ENT_ID_FIREBALL,
-	ENT_ID_PARTICLE,
 	ENT_ID_RAGDOLL,
 	ENT_ID_GROUNDGUY,
 	ENT_ID_CLOUD,
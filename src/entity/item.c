@@ -67,5 +67,5 @@ void ent_draw_ITEM(EntITEM *e)
 
 void ent_destroy_ITEM(EntITEM *e)
 {
-	ENT_DEL(e);
+	ENT_DEL_MARK(e);
 }
@@ -47,6 +47,9 @@ typedef struct{
 	EntItemId id;
 } EntITEM;
 
+// Rectangle in the game world that an item is drawn in, big enough for the biggest item texture
+#define	ENT_BOUNDS_ITEM(ent)	((SDL_Rect) {(ent)->x - 10, (ent)->y - 16, 20, 16})
+
 // Initializes the ent_item_tex array (defined in item.c)
 void ent_item_init(void);
 
@@ -15,9 +15,11 @@
 #include "../error.h"
 #include "../input.h"
 #include "../map.h"
+#include "../particle.h"
 #include "../sound.h"
 #include "../texture.h"
 #include "../timestep.h"
+#include "../trace.h"
 #include "../util/rep.h"
 #include "../util/math.h"
 #include "../video.h"
@@ -34,15 +36,6 @@
 // Since g_player is used so frequently here, p is an alias for it
 #define	p	g_player
 
-// Player controls
-#define	P_KEY_UP	SDL_SCANCODE_W
-#define	P_KEY_DOWN	SDL_SCANCODE_S
-#define	P_KEY_LEFT	SDL_SCANCODE_A
-#define	P_KEY_RIGHT	SDL_SCANCODE_D
-#define	P_KEY_JUMP	SDL_SCANCODE_K
-#define	P_KEY_SHOOT	SDL_SCANCODE_J
-#define	P_KEY_INTERACT	SDLK_w
-
 // The number of pixels a fireball will travel in a straight line at roughly 60fps
 #define	P_FIREBALL_SPD		8
 
@@ -124,6 +117,8 @@ void ent_player_update(void)
 	if (p.hp <= 0)
 		return;
 
+	ECM_BODY_SAVE_PREV(p.b);
+
 	// Sign of movement speed
 	short msign = 0;
 
@@ -175,7 +170,7 @@ l_move_done:
 		p.b.hsp = 0;
 
 	// Setting on ground flag
-	p.on_ground = ecm_body_tile_collide(&p.b, 0, 1);
+	p.on_ground = ecm_body_tile_below(&p.b, 0);
 
 	// Setting jump state based on on_ground state
 	if (p.on_ground)
@@ -296,7 +291,7 @@ l_move_done:
 
 				// TODO: bounds checking
 				if (!g_map.editing)
-					g_col.data[g_col.active_index].map[item->y / TILE_SIZE - 1][item->x / TILE_SIZE] = ENT_TILE_NONE;
+					map_grid_set(&g_col.data[g_col.active_index].map, item->x / TILE_SIZE, item->y / TILE_SIZE - 1, ENT_TILE_NONE);
 				snd_play(snd_bubble);
 
 				break;
@@ -311,7 +306,7 @@ l_move_done:
 				// Remove coin from collector
 				// TODO: bounds checking
 				if (!g_map.editing)
-					g_col.data[g_col.active_index].map[item->y / TILE_SIZE][item->x / TILE_SIZE] = ENT_TILE_NONE;
+					map_grid_set(&g_col.data[g_col.active_index].map, item->x / TILE_SIZE, item->y / TILE_SIZE, ENT_TILE_NONE);
 				snd_play(snd_coin);
 				
 				break;
@@ -324,7 +319,7 @@ l_move_done:
 				break;
 			}
 			REP (10)
-				ent_new_PARTICLE(p.b.x, p.b.y, PTCL_STAR);
+				ptcl_new(p.b.x, p.b.y, PTCL_STAR);
 			ent_destroy_ITEM(item);
 		}
 	}
@@ -379,9 +374,9 @@ l_move_done:
 	// Entering doors
 	{
 		bool in_door = false;
-		EntDOOR *e = g_er[ENT_ID_DOOR]->e;
 		for (int i = 0; i < g_er[ENT_ID_DOOR]->len; i++)
 		{
+			EntDOOR *e = ENT_ARRAY_AT(g_er[ENT_ID_DOOR], i);
 			SDL_Rect drect = ECM_BODY_GET_CRECT(e->b);
 			if (check_rect(&p.crect, &drect))
 			{
@@ -400,10 +395,9 @@ l_move_done:
 				
 				// Load the new map
 				g_ent_door_last_used = e->did;
-				if (map_load_txt(g_ent_door_map_path[e->did], false))
+				if (TRACE_INT("map_load", map_load(g_ent_door_map_path[e->did], false)))
 					abort();
 			}
-			e++;
 		}
 		if (in_door == false)
 			p.door_stop = false;
@@ -420,12 +414,16 @@ void ent_player_draw(void)
 	// If the player has iframes and this value is false, the player won't be drawn every other frame so that they "blink"
 	static bool iframes_blink = false;
 
+	// Player position interpolated between the previous and current simulation ticks
+	const double x = TS_LERP(p.b.xprev, p.b.x);
+	const double y = TS_LERP(p.b.yprev, p.b.y);
+
 	// Player source and destination rectangles
 	const SDL_Rect *p_srect = &g_spr_egg[p.sprite];
-	//const SDL_Rect p_drect = {p.b.x + g_cam.xshift - 6, p.b.y + g_cam.yshift - 6, SPR_EGG_W, SPR_EGG_H};
+	//const SDL_Rect p_drect = {x + g_cam.xshift - 6, y + g_cam.yshift - 6, SPR_EGG_W, SPR_EGG_H};
 	const SDL_Rect p_drect = {
-			p.b.x + p.b.w / 2 - SPR_EGG_W / 2 + g_cam.xshift,
-			p.b.y - (SPR_EGG_H - p.b.h) + g_cam.yshift,
+			x + p.b.w / 2 - SPR_EGG_W / 2 + g_cam.xshift,
+			y - (SPR_EGG_H - p.b.h) + g_cam.yshift,
 			SPR_EGG_W,
 			SPR_EGG_H,
 	};
@@ -433,8 +431,8 @@ void ent_player_draw(void)
 	// Draw player hitbox
 	/*
 	const SDL_Rect p_hrect = {
-		p.b.x + g_cam.xshift,
-		p.b.y + g_cam.yshift,
+		x + g_cam.xshift,
+		y + g_cam.yshift,
 		p.b.w + 1,
 		p.b.h + 1,
 	};
@@ -473,8 +471,8 @@ void ent_player_draw(void)
 		};
 
 		SDL_Rect drect = {
-			p.b.x + g_cam.xshift + 2 + sin(f) * mag,
-			p.b.y + g_cam.yshift + 2 + cos(f) * mag,
+			x + g_cam.xshift + 2 + sin(f) * mag,
+			y + g_cam.yshift + 2 + cos(f) * mag,
 			.w = 16,
 			.h = 16,
 		};
@@ -496,12 +494,12 @@ void ent_player_keydown(SDL_Keycode key)
 		p.trumpet_shots = g_player.trumpet_shots_reset = 8;
 		p.has_trumpet = true;
 		g_ent_door_last_used = -1;
-		if (map_load_txt(g_map.path, g_map.editing) == ERR_NO_RECOVER)
+		if (TRACE_INT("map_load", map_load(g_map.path, g_map.editing)) == ERR_NO_RECOVER)
 			abort();
 		break;
 	// Load game
 	case SDLK_x:
-		spdl_load();
+		TRACE_INT("spdl_load", spdl_load());
 		break;
 	// Switch music
 	case SDLK_m:
@@ -522,28 +520,27 @@ void ent_player_keydown(SDL_Keycode key)
 	case P_KEY_INTERACT:
 		{
 			// Interacting with savebirds
-			EntSAVEBIRD *e = g_er[ENT_ID_SAVEBIRD]->e;
 			SDL_Rect orect = {.w = SPR_EGG_W, .h = SPR_EGG_H};
 			for (int i = 0; i < g_er[ENT_ID_SAVEBIRD]->len; i++)
 			{
+				EntSAVEBIRD *e = ENT_ARRAY_AT(g_er[ENT_ID_SAVEBIRD], i);
 				orect.x = e->x;
 				orect.y = e->y;
 				if (check_rect(&p.crect, &orect))
 				{
 					p.hp = p.maxhp;
-					switch (spdl_save())
+					switch (TRACE_INT("spdl_save", spdl_save()))
 					{
 					case ERR_NO_RECOVER:
 						abort();
 					case ERR_RECOVER:
 						break;
 					case ERR_NONE:
-						ent_new_PARTICLE(p.b.x, p.b.y, PTCL_SAVE);
+						ptcl_new(p.b.x, p.b.y, PTCL_SAVE);
 						snd_play(snd_bubble);
 						break;
 					}
 				}
-				e++;
 			}
 		}
 		break;
@@ -565,7 +562,7 @@ bool ent_player_damage(int power)
 	p.hp -= power;
 	p.iframes = 60.0;
 	REP (3)
-		ent_new_PARTICLE(p.b.x + 16, p.b.y + 16, PTCL_BUBBLE);
+		ptcl_new(p.b.x + 16, p.b.y + 16, PTCL_BUBBLE);
 	snd_play(snd_splode);
 
 	// Checking for player death
@@ -574,7 +571,7 @@ bool ent_player_damage(int power)
 		p.hp = 0;
 		ent_new_RAGDOLL(p.b.x, p.b.y - 2, p.b.hsp * -1, -5, TEX_EGG_EGG);
 		REP (30)
-			ent_new_PARTICLE(p.b.x + 16, p.b.y + 16, PTCL_BUBBLE);
+			ptcl_new(p.b.x + 16, p.b.y + 16, PTCL_BUBBLE);
 	}
 	return true;
 }
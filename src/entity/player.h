@@ -12,6 +12,15 @@
 #include "c_body.h"
 #include "c_sprite.h"
 
+// Player controls
+#define	P_KEY_UP	SDL_SCANCODE_W
+#define	P_KEY_DOWN	SDL_SCANCODE_S
+#define	P_KEY_LEFT	SDL_SCANCODE_A
+#define	P_KEY_RIGHT	SDL_SCANCODE_D
+#define	P_KEY_JUMP	SDL_SCANCODE_K
+#define	P_KEY_SHOOT	SDL_SCANCODE_J
+#define	P_KEY_INTERACT	SDLK_w
+
 typedef struct{
 	// Body
 	EcmBody b;
@@ -13,7 +13,6 @@
 #include "../collision.h"
 #include "../random.h"
 #include "entity.h"
-#include "particle.h"
 #include "c_body.h"
 #include "c_sprite.h"
 #include "ragdoll.h"
@@ -21,36 +20,24 @@
 EntRAGDOLL *ent_new_RAGDOLL(float x, float y, float hsp, float vsp, TexEgg tex)
 {
 	ENT_NEW(RAGDOLL);
-	e->b.x = x;
-	e->b.y = y;
-	e->b.w = 30;
-	e->b.h = 30;
-	e->b.hsp = hsp;
-	e->b.vsp = vsp;
+	if ((e->b = ecm_body_new(&(EcmBody) {.x = x, .y = y, .w = 30, .h = 30, .hsp = hsp, .vsp = vsp, .grv = 0.2f, .xprev = x, .yprev = y, .flags = ECM_BODY_BOUNCE})) == -1)
+	{
+		ENT_DEL_MARK(e);
+		return NULL;
+	}
 	e->tex = tex;
-	e->b.grv = 0.2f;
 	e->bounce_frames = 0;
 	return e;
 }
 
 void ent_update_RAGDOLL(EntRAGDOLL *e)
 {
-	// Movement and collision
-	if (ecm_body_tile_collide(&e->b, e->b.hsp * g_ts, 0))
-		e->b.hsp *= -0.9f;
-	else
-		e->b.x += e->b.hsp * g_ts;
-	e->b.vsp += e->b.grv * g_ts;
-	if (ecm_body_tile_collide(&e->b, 0, e->b.vsp * g_ts))
-	{
+	EcmBody *b = ECM_BODY(e->b);
+	if (b->hit & ECM_BODY_HIT_VERT)
 		e->bounce_frames = 16;
-		e->b.vsp *= -0.9f;
-		e->b.hsp *= 0.98f;
-	}
-	else
-		e->b.y += e->b.vsp * g_ts;
+	b->ts = g_ts;
 
-	SDL_Rect crect = ECM_BODY_GET_CRECT(e->b);
+	SDL_Rect crect = ECM_BODY_GET_CRECT(*b);
 
 	// Be knocked around by fireballs
 	{
@@ -58,16 +45,17 @@ void ent_update_RAGDOLL(EntRAGDOLL *e)
 		if ((fireball = check_ent_fireball(&crect)) != NULL)
 		{
 			ent_destroy_FIREBALL(fireball);
-			e->b.hsp += fireball->hsp * 2;
-			e->b.vsp += fireball->vsp * 2;
-			e->b.vsp -= spdl_random() / 128.0f;
+			b->hsp += fireball->hsp * 2;
+			b->vsp += fireball->vsp * 2;
+			b->vsp -= spdl_random() / 128.0f;
 		}
 	}
 }
 
 void ent_draw_RAGDOLL(EntRAGDOLL *e)
 {
-	SDL_Rect drect = {e->b.x + g_cam.xshift, e->b.y + g_cam.yshift, 32, 32};
+	const EcmBody *b = ECM_BODY(e->b);
+	SDL_Rect drect = {TS_LERP(b->xprev, b->x) + g_cam.xshift, TS_LERP(b->yprev, b->y) + g_cam.yshift, 32, 32};
 	SDL_Rect srect = {.w = 32, .h = 32};
 	if (e->bounce_frames > 0)
 	{
@@ -88,5 +76,6 @@ void ent_draw_RAGDOLL(EntRAGDOLL *e)
 
 void ent_destroy_RAGDOLL(EntRAGDOLL *e)
 {
-	ENT_DEL(e);
+	ecm_body_del(e->b);
+	ENT_DEL_MARK(e);
 }
@@ -16,7 +16,9 @@
 // Ragdoll type
 typedef struct{
 	EcmBase base;
-	EcmBody b;
+
+	// Body in the body store
+	EcmBodyId b;
 	
 	// True when the ragdoll is still moving
 	bool active : 1;
@@ -28,6 +30,9 @@ typedef struct{
 	short bounce_frames;
 } EntRAGDOLL;
 
+// Rectangle in the game world that a ragdoll is drawn in, with room for the falling sprite being drawn lower
+#define	ENT_BOUNDS_RAGDOLL(ent)	((SDL_Rect) {ECM_BODY((ent)->b)->x, ECM_BODY((ent)->b)->y, 32, 42})
+
 EntRAGDOLL *ent_new_RAGDOLL(float x, float y, float hsp, float vsp, TexEgg tex);
 void ent_update_RAGDOLL(EntRAGDOLL *e);
 void ent_draw_RAGDOLL(EntRAGDOLL *e);
@@ -11,7 +11,7 @@
 #include "root.h"
 
 // Shorthand for creating a new entity array and adding it to the root entity array
-#define	EAN(name, len_max)		EntArray *name = ent_array_new(len_max, sizeof(Ent##name)); \
+#define	EAN(name)		EntArray *name = ent_array_new(sizeof(Ent##name)); \
 					g_ent_root_array[ENT_ID_##name] = name
 
 // See root.h for an explanation of what the root entity array is
@@ -23,19 +23,18 @@ EntArray **const g_er = g_ent_root_array;
 int ent_root_array_init(void)
 {
 	g_ent_root_array[ENT_ID_PLAYER] = NULL;
-	EAN(ITEM, 5000);
-	EAN(FIREBALL, 100);
-	EAN(PARTICLE, 5000);
-	EAN(RAGDOLL, 200);
-	EAN(GROUNDGUY, 200);
-	EAN(CLOUD, 160);
-	EAN(SLIDEGUY, 100);
-	EAN(EVILBALL, 200);
-	EAN(TURRET, 60);
-	EAN(DOOR, ENT_DOOR_MAX);
-	EAN(SAVEBIRD, 20);
-	EAN(BARRIER, 100);
-	EAN(COOLEGG, 100);
+	EAN(ITEM);
+	EAN(FIREBALL);
+	EAN(RAGDOLL);
+	EAN(GROUNDGUY);
+	EAN(CLOUD);
+	EAN(SLIDEGUY);
+	EAN(EVILBALL);
+	EAN(TURRET);
+	EAN(DOOR);
+	EAN(SAVEBIRD);
+	EAN(BARRIER);
+	EAN(COOLEGG);
 
 	// Check for errors in allocating mem for entity arrays
 	for (int i = 1; i < ENT_MAX; i++)
@@ -7,6 +7,7 @@
 #ifndef	ENTITY_SAVEBIRD_H
 #define	ENTITY_SAVEBIRD_H
 
+#include "c_sprite.h"
 #include "entity.h"
 
 // Entity item type
@@ -16,6 +17,9 @@ typedef struct{
 	int y;
 } EntSAVEBIRD;
 
+// Rectangle in the game world that a savebird is drawn in
+#define	ENT_BOUNDS_SAVEBIRD(ent)	((SDL_Rect) {(ent)->x, (ent)->y, SPR_EGG_W, SPR_EGG_H})
+
 EntSAVEBIRD *ent_new_SAVEBIRD(int x, int y);
 void ent_update_SAVEBIRD(EntSAVEBIRD *e);
 void ent_draw_SAVEBIRD(EntSAVEBIRD *e);
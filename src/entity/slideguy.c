@@ -22,43 +22,52 @@
 EntSLIDEGUY *ent_new_SLIDEGUY(int x, int y, int hp, float acc, float jsp, BarrierTag btag)
 {
 	ENT_NEW(SLIDEGUY);
-	e->e.b = (EcmBody) {x, y, 31, 31, 0, 0, 0.2};
+	if ((e->e.b = ecm_body_new(&(EcmBody) {.x = x, .y = y, .w = 31, .h = 31, .grv = 0.2, .xprev = x, .yprev = y})) == -1)
+	{
+		ENT_DEL_MARK(e);
+		return NULL;
+	}
 	e->e.spr = (EcmEggSpr) {SPR_EGG_IDLE, TEX_EGG_EVIL, SDL_FLIP_NONE, 0};
 	e->e.hp = hp;
 	e->acc = acc;
 	e->jsp = jsp;
 	e->btag = btag;
+	barrier_add_carrier(btag);
 	return e;
 }
 
 void ent_update_SLIDEGUY(EntSLIDEGUY *e)
 {
+	EcmBody *b = ECM_BODY(e->e.b);
+
+	// Bounce off of walls
+	if (b->hit & ECM_BODY_HIT_HORI)
+		b->hsp *= -1;
+	if (b->hit & ECM_BODY_HIT_VERT)
+	{
+		// Jump when the ground is hit
+		if (b->vsp >= 0)
+			b->vsp = e->jsp;
+		else
+			b->vsp = 0;
+	}
+
 	// Accelerate towards player
-	if (g_player.b.x > e->e.b.x)
+	if (g_player.b.x > b->x)
 	{
-		e->e.b.hsp += e->acc * g_ts;
+		b->hsp += e->acc * g_ts;
 		e->e.spr.flip = SDL_FLIP_NONE;
 	}
 	else
 	{
-		e->e.b.hsp -= e->acc * g_ts;
+		b->hsp -= e->acc * g_ts;
 		e->e.spr.flip = SDL_FLIP_HORIZONTAL;
 	}
 
-	// Cap speeds and apply movement
-	e->e.b.hsp = clampf(e->e.b.hsp, -E_MAX_HSP, E_MAX_HSP);
-	if (ecm_body_move_hori(&e->e.b))
-		e->e.b.hsp *= -1;
-
-	e->e.b.vsp = clampf(e->e.b.vsp + e->e.b.grv * g_ts, -E_MAX_VSP, E_MAX_VSP);
-	if (ecm_body_move_vert(&e->e.b))
-	{
-		// Jump when the ground is hit
-		if (e->e.b.vsp >= 0)
-			e->e.b.vsp = e->jsp;
-		else
-			e->e.b.vsp = 0;
-	}
+	// Cap speeds
+	b->hsp = clampf(b->hsp, -E_MAX_HSP, E_MAX_HSP);
+	b->vsp_max = E_MAX_VSP;
+	b->ts = g_ts;
 	
 	ecm_egg_update_animation(&e->e);
 	if (ecm_egg_evil_handle_collisions(&e->e))
@@ -72,7 +81,7 @@ void ent_draw_SLIDEGUY(EntSLIDEGUY *e)
 
 void ent_destroy_SLIDEGUY(EntSLIDEGUY *e)
 {
-	barrier_send_check_request(e->btag);
+	barrier_remove_carrier(e->btag);
 	ecm_egg_die(&e->e);
 	ENT_DEL_MARK(e);
 }
@@ -10,6 +10,7 @@
 #include <SDL2/SDL.h>
 
 #include "../barrier.h"
+#include "../tile/data.h"	// For TILE_SIZE
 
 #include "c_egg.h"
 #include "entity.h"
@@ -28,6 +29,13 @@ typedef struct{
 	BarrierTag btag;
 } EntSLIDEGUY;
 
+// Rectangle in the game world that a slideguy is drawn in
+#define	ENT_BOUNDS_SLIDEGUY(ent)	((SDL_Rect) {ECM_BODY((ent)->e.b)->x, ECM_BODY((ent)->e.b)->y, SPR_EGG_W, SPR_EGG_H})
+
+// Distances from the screen that slideguys are updated less often and put to sleep at (see ENT_UPDATE_LOD() in all.h)
+#define	ENT_LOD_NEAR_SLIDEGUY	(TILE_SIZE * 4)
+#define	ENT_LOD_FAR_SLIDEGUY	(TILE_SIZE * 16)
+
 EntSLIDEGUY *ent_new_SLIDEGUY(int x, int y, int hp, float acc, float jsp, BarrierTag btag);
 void ent_update_SLIDEGUY(EntSLIDEGUY *e);
 void ent_draw_SLIDEGUY(EntSLIDEGUY *e);
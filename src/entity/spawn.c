@@ -0,0 +1,97 @@
+/*
+ * spawn.c contains the spawn queue, which holds entities spawned while entities are being updated until they can be added to their arrays.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "../error.h"
+#include "../util/type.h"	// For Byte
+#include "array.h"
+#include "grid.h"
+#include "id.h"
+#include "root.h"
+#include "spawn.h"
+
+// Entities of one type waiting to be added to their array
+typedef struct{
+	// Entities packed together in the order they were spawned in
+	Byte *ent;
+
+	// # of entities in the queue and # of entities there's room for
+	int len;
+	int len_max;
+} EntSpawnQueue;
+
+// Queue of each entity type
+static EntSpawnQueue g_ent_spawn[ENT_MAX];
+
+// True if spawned entities are put in queues
+static bool g_ent_spawn_queueing = false;
+
+// Returns a pointer to space for a new entity of a type, returns NULL on error
+// If spawns are being queued, the space is in the type's queue and the pointer is only valid until the next entity of the same type is spawned
+void *ent_spawn_add(EntId id)
+{
+	if (!g_ent_spawn_queueing)
+	{
+		ent_grid_dirty(id);
+		return ent_array_add(g_er[id]);
+	}
+
+	EntSpawnQueue *q = &g_ent_spawn[id];
+	const size_t ent_size = g_er[id]->ent_size;
+	if (q->len == q->len_max)
+	{
+		const int len_max = q->len_max == 0 ? ENT_SPAWN_LEN_MIN : q->len_max * 2;
+		Byte *ent = realloc(q->ent, ent_size * len_max);
+		if (ent == NULL)
+		{
+			PERR("failed to allocate mem for entity spawn queue");
+			return NULL;
+		}
+		q->ent = ent;
+		q->len_max = len_max;
+	}
+	return q->ent + ent_size * q->len++;
+}
+
+// Starts putting spawned entities in queues instead of their entity arrays
+void ent_spawn_begin(void)
+{
+	g_ent_spawn_queueing = true;
+}
+
+// Adds all queued entities to their entity arrays and stops queueing spawned entities
+void ent_spawn_end(void)
+{
+	g_ent_spawn_queueing = false;
+	for (int i = 1; i < ENT_MAX; i++)
+	{
+		EntSpawnQueue *q = &g_ent_spawn[i];
+		if (q->len == 0)
+			continue;
+		if (ent_array_append(i, q->ent, q->len))
+			PERR("failed to add %d queued entities to entity array %d", q->len, i);
+		q->len = 0;
+	}
+}
+
+// Removes all queued entities without adding them to their entity arrays
+void ent_spawn_reset(void)
+{
+	for (int i = 1; i < ENT_MAX; i++)
+		g_ent_spawn[i].len = 0;
+}
+
+// Frees all spawn queues
+void ent_spawn_free(void)
+{
+	for (int i = 1; i < ENT_MAX; i++)
+	{
+		free(g_ent_spawn[i].ent);
+		g_ent_spawn[i].ent = NULL;
+		g_ent_spawn[i].len = 0;
+		g_ent_spawn[i].len_max = 0;
+	}
+}
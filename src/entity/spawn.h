@@ -0,0 +1,31 @@
+/*
+ * spawn.h contains the spawn queue, which holds entities spawned while entities are being updated until they can be added to their arrays.
+ *
+ * Between ent_spawn_begin() and ent_spawn_end(), ENT_NEW() puts new entities in a queue for their type instead of their entity array, so no entity array changes while it's being iterated through. ent_spawn_end() adds the queued entities of each type to the end of its array all at once, in the order they were spawned in. Entities spawned while they're queued aren't in their arrays yet, so they can't be found by searches, updated, or referred to with handles until ent_spawn_end() is called.
+ */
+
+#ifndef	ENTITY_SPAWN_H
+#define	ENTITY_SPAWN_H
+
+#include "id.h"
+
+// # of entities a spawn queue has room for when it's first allocated
+#define	ENT_SPAWN_LEN_MIN	16
+
+// Returns a pointer to space for a new entity of a type, returns NULL on error
+// If spawns are being queued, the space is in the type's queue and the pointer is only valid until the next entity of the same type is spawned
+void *ent_spawn_add(EntId id);
+
+// Starts putting spawned entities in queues instead of their entity arrays
+void ent_spawn_begin(void);
+
+// Adds all queued entities to their entity arrays and stops queueing spawned entities
+void ent_spawn_end(void);
+
+// Removes all queued entities without adding them to their entity arrays
+void ent_spawn_reset(void);
+
+// Frees all spawn queues
+void ent_spawn_free(void);
+
+#endif
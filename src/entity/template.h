@@ -19,6 +19,9 @@ typedef struct{
 	EcmBase base;
 } EntTEMPLATE;
 
+// Rectangle in the game world that a template entity is drawn in, used to cull it when it's off screen
+#define	ENT_BOUNDS_TEMPLATE(ent)	((SDL_Rect) {0, 0, 0, 0})
+
 EntTEMPLATE *ent_new_TEMPLATE(void);
 void ent_update_TEMPLATE(EntTEMPLATE *e);
 void ent_draw_TEMPLATE(EntTEMPLATE *e);
@@ -65,8 +68,9 @@ void ent_destroy_TEMPLATE(EntTEMPLATE *e)
 //
 // id.h		add ENT_ID_TEMPLATE to EntId
 // all.h	add #include "template.h"
-// root.c	add EAN(TEMPLATE, 100);
-// ../main.c	add ENT_UPDATE(TEMPLATE); and ENT_DRAW(TEMPLATE);
+// root.c	add EAN(TEMPLATE);
+// ../sim.c	add ENT_UPDATE(TEMPLATE); or ENT_UPDATE_LOD(TEMPLATE); with ENT_LOD_NEAR_TEMPLATE and ENT_LOD_FAR_TEMPLATE defined in template.h
+// ../main.c	add ENT_DRAW(TEMPLATE);
 //
 // OPTIONAL:
 // 
@@ -9,6 +9,7 @@
 #include "../video.h"
 #include "../texture.h"
 #include "../camera.h"
+#include "../job.h"
 #include "../sound.h"
 #include "../timestep.h"
 #include "../random.h"
@@ -25,6 +26,9 @@
 #define	FIRE_TICK_INC	4
 #define	EVILBALL_SPD	4.0f
 
+// Makes a turret fire an evilball in the direction it's facing, for firing from jobs
+static void ent_turret_fire(void *turret);
+
 EntTURRET *ent_new_TURRET(int x, int y)
 {
 	static int fire_offset = 0;
@@ -70,17 +74,9 @@ void ent_update_TURRET(EntTURRET *e)
 		
 	if ((e->fire_tick -= g_ts) <= 0.0)
 	{
-		// Play sound if nearly on-screen
-		if (cam_can_see_point(e->x, e->y, TILE_SIZE * 14))
-			snd_play(snd_shoot);
 		e->fire_tick = FIRE_TICK_RESET;
 		e->fire_spr_frames = 14;
-
-		// Fireball speeds
-		const float hsp = cos(e->dir) * EVILBALL_SPD;
-		const float vsp = sin(e->dir) * EVILBALL_SPD;
-
-		ent_new_EVILBALL(e->x + TILE_SIZE / 2 + cos(e->dir) * 6, e->y + TILE_SIZE / 2 + sin(e->dir) * 3, hsp, vsp);
+		job_cmd(ent_turret_fire, e);
 	}
 }
 
@@ -110,3 +106,19 @@ void ent_destroy_TURRET(EntTURRET *e)
 {
 	ENT_DEL_MARK(e);
 }
+
+// Makes a turret fire an evilball in the direction it's facing, for firing from jobs
+static void ent_turret_fire(void *turret)
+{
+	const EntTURRET *e = turret;
+
+	// Play sound if nearly on-screen
+	if (cam_can_see_point(e->x, e->y, TILE_SIZE * 14))
+		snd_play(snd_shoot);
+
+	// Fireball speeds
+	const float hsp = cos(e->dir) * EVILBALL_SPD;
+	const float vsp = sin(e->dir) * EVILBALL_SPD;
+
+	ent_new_EVILBALL(e->x + TILE_SIZE / 2 + cos(e->dir) * 6, e->y + TILE_SIZE / 2 + sin(e->dir) * 3, hsp, vsp);
+}
@@ -7,28 +7,38 @@
 #ifndef	ENTITY_TURRET_H
 #define	ENTITY_TURRET_H
 
+#include "../tile/data.h"	// For TILE_SIZE
+
 #include "c_sprite.h"
 #include "entity.h"
 
 // Entity item type
 typedef struct{
 	EcmBase base;
-	SprTurret spr;
+	SprTurret spr ENT_COMPACT_BITS(4);
 
 	// Position
 	int x;
 	int y;
 
 	// Ticks remaining until the turret fires next
-	double fire_tick;
+	EcmReal fire_tick;
 
 	// Ticks remaining to show the turret's firing face
 	short fire_spr_frames;
 
 	// Angle measurement from turret to player
-	double dir;
+	EcmReal dir;
 } EntTURRET;
 
+// Rectangle in the game world that a turret is drawn in, with room for its face to stick out of its body
+#define	ENT_BOUNDS_TURRET(ent)	((SDL_Rect) {(ent)->x - 8, (ent)->y - 8, TILE_SIZE + 16, TILE_SIZE + 16})
+
+// Distances from the screen that turrets are updated less often and put to sleep at (see ENT_UPDATE_LOD() in all.h)
+// Far enough that turrets whose evilballs can reach the screen keep firing
+#define	ENT_LOD_NEAR_TURRET	(TILE_SIZE * 4)
+#define	ENT_LOD_FAR_TURRET	(TILE_SIZE * 40)
+
 EntTURRET *ent_new_TURRET(int x, int y);
 void ent_update_TURRET(EntTURRET *e);
 void ent_draw_TURRET(EntTURRET *e);
@@ -0,0 +1,269 @@
+/*
+ * genmap.c contains functions for generating random maps to stress test the game.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL2/SDL.h>
+
+#include "dir.h"
+#include "entity/tile.h"
+#include "error.h"
+#include "genmap.h"
+#include "map.h"
+#include "tile/data.h"
+#include "util/string.h"
+
+// Max size of a void rectangle in tiles
+#define	GENMAP_VR_SIZE_MAX	16
+
+// Size of the space left empty around the player spawn point in the top left corner of the map, in tiles
+#define	GENMAP_SPAWN_CLEAR	3
+
+// Parameters used for anything not given on the command line
+const GenMapParams g_genmap_default = {
+	.width = 200,
+	.height = 200,
+	.seed = 1,
+	.solid = 0.15,
+	.spike = 0.02,
+	.turret = 0.0005,
+	.groundguy = 0.002,
+	.coin = 0.01,
+	.void_rects = 4,
+};
+
+// Returns the next number from the random number generator with state *state
+static uint32_t genmap_rand(uint32_t *state);
+
+// Returns a random number from 0 to 1 (not including 1) from the random number generator with state *state
+static double genmap_rand01(uint32_t *state);
+
+// Generates a map and writes it to the map file at path
+// Returns nonzero on error
+int genmap_write(const char *path, const GenMapParams *params)
+{
+	const int w = params->width;
+	const int h = params->height;
+	if (w < 3 || h < 3 || w > MAP_WIDTH_MAX || h > MAP_HEIGHT_MAX)
+	{
+		PERR("generated map dimensions must be from 3x3 to " STR(MAP_WIDTH_MAX) "x" STR(MAP_HEIGHT_MAX));
+		return 1;
+	}
+	if (strlen(path) >= MAP_PATH_MAX)
+	{
+		PERR("map path longer than MAP_PATH_MAX (" STR(MAP_PATH_MAX) " chars)");
+		return 1;
+	}
+
+	char *map;
+	if ((map = malloc(w * h)) == NULL)
+	{
+		PERR("failed to allocate mem for generated map");
+		return 1;
+	}
+
+	const char air = g_tile_md[TILE_AIR].map_char;
+	const char stone = g_tile_md[TILE_STONE].map_char;
+	const char spike = g_tile_md[TILE_SPIKE_UP].map_char;
+	const char turret = g_ent_tile[ENT_TILE_TURRET].map_char;
+	const char groundguy = g_ent_tile[ENT_TILE_GROUNDGUY].map_char;
+	const char coin = g_ent_tile[ENT_TILE_COIN].map_char;
+
+	// Each kind of tile takes up the part of the range from 0 to 1 after the one before it
+	const double solid_max = params->solid;
+	const double spike_max = solid_max + params->spike;
+	const double turret_max = spike_max + params->turret;
+	const double groundguy_max = turret_max + params->groundguy;
+	const double coin_max = groundguy_max + params->coin;
+
+	uint32_t state = params->seed;
+	for (int y = 0; y < h; y++)
+	{
+		for (int x = 0; x < w; x++)
+		{
+			char *c = &map[y * w + x];
+
+			// Stone border
+			if (x == 0 || y == 0 || x == w - 1 || y == h - 1)
+			{
+				*c = stone;
+				continue;
+			}
+
+			// Space around the player spawn point
+			if (x <= GENMAP_SPAWN_CLEAR && y <= GENMAP_SPAWN_CLEAR)
+			{
+				*c = air;
+				continue;
+			}
+
+			const double r = genmap_rand01(&state);
+			if (r < solid_max)
+				*c = stone;
+			else if (r < spike_max)
+				*c = spike;
+			else if (r < turret_max)
+				*c = turret;
+			else if (r < groundguy_max)
+				*c = groundguy;
+			else if (r < coin_max)
+				*c = coin;
+			else
+				*c = air;
+		}
+	}
+
+	char fullpath[RES_PATH_MAX];
+	snprintf(fullpath, RES_PATH_MAX, DIR_MAP "/%s", path);
+	FILE *map_file;
+	if ((map_file = fopen(fullpath, "w")) == NULL)
+	{
+		PERR("failed to open map file \"%s\"", fullpath);
+		free(map);
+		return 1;
+	}
+
+	// Player spawn point
+	map[1 * w + 1] = g_ent_tile[ENT_TILE_PLAYER].map_char;
+
+	// Void rectangles are written as options, but their barriers go in the tile data, so they're placed before it's written
+	char options[VOID_RECT_LIST_LEN][64];
+	const int void_rects_max = params->void_rects < VOID_RECT_LIST_LEN ? params->void_rects : VOID_RECT_LIST_LEN;
+	int void_rects = 0;
+	for (int i = 0; i < void_rects_max; i++)
+	{
+		int rw = 1 + genmap_rand(&state) % (w - 2 < GENMAP_VR_SIZE_MAX ? w - 2 : GENMAP_VR_SIZE_MAX);
+		int rh = 1 + genmap_rand(&state) % (h - 2 < GENMAP_VR_SIZE_MAX ? h - 2 : GENMAP_VR_SIZE_MAX);
+		int rx = 1 + genmap_rand(&state) % (w - 1 - rw);
+		int ry = 1 + genmap_rand(&state) % (h - 1 - rh);
+
+		// Keep the barrier out of the space around the player spawn point by moving the rectangle below it or right of it, shrinking it to fit in the map
+		if (rx <= GENMAP_SPAWN_CLEAR && ry <= GENMAP_SPAWN_CLEAR)
+		{
+			if (h - 2 > GENMAP_SPAWN_CLEAR)
+			{
+				ry = GENMAP_SPAWN_CLEAR + 1;
+				if (ry + rh > h - 1)
+					rh = h - 1 - ry;
+			}
+			else if (w - 2 > GENMAP_SPAWN_CLEAR)
+			{
+				rx = GENMAP_SPAWN_CLEAR + 1;
+				if (rx + rw > w - 1)
+					rw = w - 1 - rx;
+			}
+			else
+			{
+				// The map is too small to hold a void rectangle
+				continue;
+			}
+		}
+
+		// Rectangles with the same top left corner would share a barrier, so only the first one is kept
+		char *barrier = &map[ry * w + rx];
+		if (*barrier == g_ent_tile[ENT_TILE_BARRIER].map_char)
+			continue;
+		*barrier = g_ent_tile[ENT_TILE_BARRIER].map_char;
+		snprintf(options[void_rects], sizeof(options[void_rects]), "r %d %d %d %d i%d", ry, rx, rh, rw, void_rects + 1);
+		void_rects++;
+	}
+
+	for (int y = 0; y < h; y++)
+	{
+		fwrite(&map[y * w], 1, w, map_file);
+		fputc('\n', map_file);
+	}
+	fprintf(map_file, ">ot %c\n", stone);
+	fprintf(map_file, ">ss 1\n");
+	for (int i = 0; i < void_rects; i++)
+		fprintf(map_file, ">%s\n", options[i]);
+
+	free(map);
+	if (fclose(map_file))
+	{
+		PERR("failed to close map file \"%s\"", fullpath);
+		return 1;
+	}
+	return 0;
+}
+
+// Generates a map using the command line arguments that follow "--genmap"
+// Returns nonzero on error
+int genmap_main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		PERR("usage: --genmap <map> <width>x<height> [seed] [name=value ...]");
+		return 1;
+	}
+
+	GenMapParams params = g_genmap_default;
+	if (sscanf(argv[1], "%dx%d", &params.width, &params.height) != 2)
+	{
+		PERR("failed to read map dimensions from \"%s\"", argv[1]);
+		return 1;
+	}
+
+	int i = 2;
+	if (i < argc && strchr(argv[i], '=') == NULL)
+		params.seed = strtoul(argv[i++], NULL, 10);
+
+	for (; i < argc; i++)
+	{
+		char name[16];
+		double value;
+		if (sscanf(argv[i], "%15[^=]=%lf", name, &value) != 2)
+		{
+			PERR("expected name=value, got \"%s\"", argv[i]);
+			return 1;
+		}
+
+		if (strcmp(name, "solid") == 0)
+			params.solid = value;
+		else if (strcmp(name, "spike") == 0)
+			params.spike = value;
+		else if (strcmp(name, "turret") == 0)
+			params.turret = value;
+		else if (strcmp(name, "groundguy") == 0)
+			params.groundguy = value;
+		else if (strcmp(name, "coin") == 0)
+			params.coin = value;
+		else if (strcmp(name, "vr") == 0)
+			params.void_rects = value;
+		else
+		{
+			PERR("unknown map generation parameter \"%s\"", name);
+			return 1;
+		}
+	}
+
+	// Map chars of entity tiles are set up at runtime
+	ent_tile_init();
+
+	if (genmap_write(argv[0], &params))
+		return 1;
+	PINF("generated %dx%d map \"%s\" with seed %u", params.width, params.height, argv[0], (unsigned int) params.seed);
+	return 0;
+}
+
+// Returns the next number from the random number generator with state *state
+static uint32_t genmap_rand(uint32_t *state)
+{
+	// Xorshift32, which needs a nonzero state
+	uint32_t x = *state != 0 ? *state : 0x9e3779b9;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+// Returns a random number from 0 to 1 (not including 1) from the random number generator with state *state
+static double genmap_rand01(uint32_t *state)
+{
+	return genmap_rand(state) / 4294967296.0;
+}
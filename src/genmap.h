@@ -0,0 +1,52 @@
+/*
+ * genmap.h contains functions for generating random maps to stress test the game.
+ *
+ * Generated maps are normal text maps (see map.h) filled with tiles and entity tiles at random. How often each kind of tile shows up is set by a density, which is the chance that any tile inside the map's stone border becomes that kind of tile. Maps are generated with their own random number generator, so the same parameters and seed always make the same map on every platform.
+ *
+ * The player spawns in the top left corner of the map, and the tiles around it are always left empty.
+ *
+ * Each void rectangle holds a barrier in its top left corner and has its own barrier tag, so groundguys spawned inside it are tied to that barrier. Void rectangles that would put their barrier on the player spawn point or on another rectangle's barrier are moved or left out, so a map may have fewer of them than asked for.
+ *
+ * Maps are generated from the command line:
+ * 	soupdl --genmap <map> <width>x<height> [seed] [name=value ...]
+ * where each name is one of solid, spike, turret, groundguy, coin (densities from 0 to 1) or vr (# of void rectangles). For example:
+ * 	soupdl --genmap stress.map 1000x1000 7 turret=0.0005 groundguy=0.0001
+ */
+
+#ifndef	GENMAP_H
+#define	GENMAP_H
+
+#include <stdint.h>
+
+// Parameters for generating a map
+typedef struct{
+	// Map dimensions in tiles
+	int width;
+	int height;
+
+	// Seed for the map's random number generator
+	uint32_t seed;
+
+	// Densities of each kind of tile
+	double solid;
+	double spike;
+	double turret;
+	double groundguy;
+	double coin;
+
+	// # of void rectangles
+	int void_rects;
+} GenMapParams;
+
+// Parameters used for anything not given on the command line
+extern const GenMapParams g_genmap_default;
+
+// Generates a map and writes it to the map file at path
+// Returns nonzero on error
+int genmap_write(const char *path, const GenMapParams *params);
+
+// Generates a map using the command line arguments that follow "--genmap"
+// Returns nonzero on error
+int genmap_main(int argc, char **argv);
+
+#endif
@@ -10,15 +10,21 @@
 
 #include "collector.h"	// For col_free()
 #include "dir.h"
+#include "entity/c_body.h"
 #include "entity/c_sprite.h"
+#include "entity/grid.h"
 #include "entity/item.h"
+#include "entity/spawn.h"
 #include "entity/tile.h"
 #include "error.h"
 #include "input.h"
+#include "job.h"
 #include "map.h"
+#include "particle.h"
 #include "sound.h"
 #include "texture.h"
-#include "timestep.h"
+#include "tile/plane.h"
+#include "trace.h"
 #include "video.h"
 
 // Initialize SDL and its subsystems, create the game window and renderer, and set the game's window's icon
@@ -28,6 +34,9 @@ static int game_init_sdl(void);
 // Frees everything allocated in game_init_sdl
 static void game_quit_sdl(void);
 
+// Keyboard state used when running headless, no keys are ever held
+static const uint8_t g_key_state_headless[SDL_NUM_SCANCODES];
+
 // Initialize SDL and its subsystems, create the game window and renderer, and set the game's window's icon
 // Returns nonzero on error
 static int game_init_sdl(void)
@@ -114,38 +123,6 @@ static int game_init_sdl(void)
 	}
 	SDL_SetColorKey(surf, SDL_TRUE, SDL_MapRGB(surf->format, 0, 0, 0));
 
-	// Set fixed timestep value
-	if (!g_vsync)
-	{
-		g_ts = 60.0 / g_no_vsync_refresh_rate;
-	}
-	else
-	{
-		SDL_DisplayMode dm;
-		int di = SDL_GetWindowDisplayIndex(g_window);
-
-		// Monitor refresh rate in Hz
-		int refresh_rate = 60;
-
-		if (SDL_GetCurrentDisplayMode(di, &dm) == 0)
-		{
-			if (dm.refresh_rate != 0)
-			{
-				// Got the refresh rate
-				refresh_rate = dm.refresh_rate;
-				goto l_got_refresh_rate;
-			}
-		}
-		PERR("couldn't get the display refresh rate. assuming 60 Hz.");
-	l_got_refresh_rate:
-
-		// Calculate timestep
-		g_ts = 60.0 / refresh_rate;
-	}
-	PINF("set timestep to %lf", g_ts);
-	if (g_ts > 2.0)
-		PERR("fixed timestep value is greater than 2. this is caused by the low refresh rate of your display. continuing with this can cause physics issues.");
-
 	// Setting game window icon
 	SDL_SetWindowIcon(g_window, surf);
 	SDL_FreeSurface(surf);
@@ -173,12 +150,12 @@ int game_init_all(void)
 	// Initializing systems
 	if (game_init_sdl())
 		return 1;
-	if (tex_load_all())
+	if (TRACE_INT("tex_load_all", tex_load_all()))
 	{
 		game_quit_sdl();
 		return 1;
 	}
-	if (snd_load_all())
+	if (TRACE_INT("snd_load_all", snd_load_all()))
 	{
 		tex_free_all();
 		game_quit_sdl();
@@ -191,6 +168,14 @@ int game_init_all(void)
 		game_quit_sdl();
 		return 1;
 	}
+	if (job_init())
+	{
+		ent_root_array_free();
+		snd_free_all();
+		tex_free_all();
+		game_quit_sdl();
+		return 1;
+	}
 
 	// Initialize misc systems that depend on game textures being loaded
 	ent_tile_init();
@@ -206,9 +191,66 @@ int game_init_all(void)
 // Frees everything allocated in game_init_all
 void game_quit_all(void)
 {
+	job_quit();
 	col_free();
 	ent_root_array_free();
+	ent_grid_free();
+	ent_spawn_free();
+	ecm_body_free();
+	tile_plane_free();
+	ptcl_free();
 	snd_free_all();
 	tex_free_all();
 	game_quit_sdl();
 }
+
+// Initializes everything needed to update the game world without a window, renderer, audio device or loaded textures & sounds
+// Returns nonzero on error
+int game_init_headless(void)
+{
+	if (SDL_Init(SDL_INIT_TIMER) < 0)
+	{
+		PERR("failed to initialize SDL. SDL Error: %s", SDL_GetError());
+		return 1;
+	}
+	if (ent_root_array_init())
+	{
+		SDL_Quit();
+		return 1;
+	}
+	if (job_init())
+	{
+		ent_root_array_free();
+		SDL_Quit();
+		return 1;
+	}
+
+	// Entity tiles & sprites only store pointers to textures here, which are NULL when running headless
+	ent_tile_init();
+	ent_item_init();
+	ecm_sprite_load_textures();
+
+	// Use the default window dimensions
+	g_screen_width = 800;
+	g_screen_height = 600;
+
+	g_key_state = g_key_state_headless;
+
+	assert(map_assert_dupchars());
+
+	return 0;
+}
+
+// Frees everything allocated in game_init_headless
+void game_quit_headless(void)
+{
+	job_quit();
+	col_free();
+	ent_root_array_free();
+	ent_grid_free();
+	ent_spawn_free();
+	ecm_body_free();
+	tile_plane_free();
+	ptcl_free();
+	SDL_Quit();
+}
@@ -12,4 +12,11 @@ int game_init_all(void);
 // Frees everything allocated in game_init_all
 void game_quit_all(void);
 
+// Initializes everything needed to update the game world without a window, renderer, audio device or loaded textures & sounds
+// Returns nonzero on error
+int game_init_headless(void);
+
+// Frees everything allocated in game_init_headless
+void game_quit_headless(void);
+
 #endif
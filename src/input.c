@@ -1,16 +1,42 @@
 /*
- * input.c contains the key_state pointer for handling keyboard input.
+ * input.c contains the key_state pointer and keydown queue for handling keyboard input.
  */
 
 #include <stdint.h>
 #include <stdio.h>
 
+#include <SDL2/SDL.h>
+
+#include "entity/player.h"	// For ent_player_keydown()
+#include "error.h"
 #include "fileio.h"
 #include "input.h"
 
 // Pointer to SDL's key_state array
 const uint8_t *g_key_state;
 
+// Keydown events waiting to be handled by the player on the next frame
+InputKeydownQueue g_keydown_queue;
+
+// Queues a keydown event to be handled by the player on the next frame
+void input_queue_keydown(SDL_Keycode key)
+{
+	if (g_keydown_queue.len == INPUT_KEYDOWN_QUEUE_LEN)
+	{
+		PERR("keydown queue is full, dropping key %d", (int) key);
+		return;
+	}
+	g_keydown_queue.key[g_keydown_queue.len++] = key;
+}
+
+// Passes all queued keydown events to the player and empties the queue
+void input_handle_keydowns(void)
+{
+	for (int i = 0; i < g_keydown_queue.len; i++)
+		ent_player_keydown(g_keydown_queue.key[i]);
+	g_keydown_queue.len = 0;
+}
+
 // Asks the player to input a string
 // The string input is stored in *dest, which should be a pointer to a char array with size len_max
 // Returns the length of the string (without \0) or -1 on error
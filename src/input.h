@@ -8,9 +8,29 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <SDL2/SDL.h>
+
+// Max # of keydown events that can be queued in one frame
+#define	INPUT_KEYDOWN_QUEUE_LEN	16
+
+// Keydown events waiting to be handled by the player on the next frame
+typedef struct{
+	SDL_Keycode key[INPUT_KEYDOWN_QUEUE_LEN];
+	int len;
+} InputKeydownQueue;
+
 // Pointer to SDL's key_state array
 extern const uint8_t *g_key_state;
 
+// Keydown events waiting to be handled by the player on the next frame
+extern InputKeydownQueue g_keydown_queue;
+
+// Queues a keydown event to be handled by the player on the next frame
+void input_queue_keydown(SDL_Keycode key);
+
+// Passes all queued keydown events to the player and empties the queue
+void input_handle_keydowns(void);
+
 // Asks the player to input a string
 // The string input is stored in *dest, which should be a pointer to a char array with size len_max
 // Returns the length of the string (without \0) or -1 on error
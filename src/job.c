@@ -0,0 +1,272 @@
+/*
+ * job.c contains the job pool, which spreads work over several threads.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <SDL2/SDL.h>
+
+#include "error.h"
+#include "job.h"
+#include "timestep.h"
+
+// # of commands a command buffer has room for when it's first allocated
+#define	JOB_CMD_LEN_MIN	64
+
+// Command stored by job_cmd()
+typedef struct{
+	JobCmdFunc func;
+	void *ptr;
+} JobCmd;
+
+// Range of indexes to work on and the commands stored while working on them
+typedef struct{
+	int start;
+	int end;
+	JobCmd *cmd;
+	int cmd_len;
+	int cmd_len_max;
+} Job;
+
+// Jobs of the current job_run() call
+static Job g_job[JOB_MAX];
+
+// # of jobs in g_job
+static int g_job_len = 0;
+
+// Job that the current thread is working on, or NULL if it isn't working on one
+static _Thread_local Job *g_job_cur = NULL;
+
+#ifdef	JOB_ENABLED
+// Function that the current jobs call
+static JobFunc g_job_func = NULL;
+
+// Timestep of the thread that called job_run(), given to the threads of the pool
+static double g_job_ts;
+
+// Index of the next job that hasn't been taken by a thread
+static SDL_atomic_t g_job_next;
+
+// # of finished jobs
+static SDL_atomic_t g_job_done;
+
+// Threads of the pool
+static SDL_Thread *g_job_thread[JOB_THREADS_MAX];
+static int g_job_threads = 0;
+
+// Locked when changing or waiting on the values below
+static SDL_mutex *g_job_mutex = NULL;
+
+// Signalled when new jobs are added or the threads should stop
+static SDL_cond *g_job_cond_start = NULL;
+
+// Signalled when a thread runs out of jobs to take
+static SDL_cond *g_job_cond_done = NULL;
+
+// Incremented every time new jobs are added, so threads can tell when to start working
+static unsigned int g_job_gen = 0;
+
+// # of threads of the pool that are taking jobs
+static int g_job_active = 0;
+
+// True if the threads should stop
+static bool g_job_stop = false;
+
+// Function run by the threads of the pool
+static int job_thread(void *data);
+
+// Takes and works on jobs until there are none left
+static void job_work(void);
+#else
+static const int g_job_threads = 0;
+#endif
+
+// Starts the threads of the job pool
+// Returns nonzero on error
+int job_init(void)
+{
+#ifdef	JOB_ENABLED
+	int threads = SDL_GetCPUCount() - 1;
+	if (threads > JOB_THREADS_MAX)
+		threads = JOB_THREADS_MAX;
+	if (threads <= 0)
+		return 0;
+
+	if ((g_job_mutex = SDL_CreateMutex()) == NULL ||
+		(g_job_cond_start = SDL_CreateCond()) == NULL ||
+		(g_job_cond_done = SDL_CreateCond()) == NULL)
+	{
+		PERR("failed to create job pool mutex. SDL Error: %s", SDL_GetError());
+		job_quit();
+		return 1;
+	}
+
+	g_job_stop = false;
+	for (g_job_threads = 0; g_job_threads < threads; g_job_threads++)
+	{
+		if ((g_job_thread[g_job_threads] = SDL_CreateThread(job_thread, "job", NULL)) == NULL)
+		{
+			// The pool still works with fewer threads
+			PERR("failed to create job pool thread. SDL Error: %s", SDL_GetError());
+			break;
+		}
+	}
+#endif
+	return 0;
+}
+
+// Stops the threads of the job pool and frees command buffers
+void job_quit(void)
+{
+#ifdef	JOB_ENABLED
+	if (g_job_mutex != NULL)
+	{
+		SDL_LockMutex(g_job_mutex);
+		g_job_stop = true;
+		SDL_CondBroadcast(g_job_cond_start);
+		SDL_UnlockMutex(g_job_mutex);
+	}
+	for (int i = 0; i < g_job_threads; i++)
+		SDL_WaitThread(g_job_thread[i], NULL);
+	g_job_threads = 0;
+
+	if (g_job_cond_done != NULL)
+		SDL_DestroyCond(g_job_cond_done);
+	if (g_job_cond_start != NULL)
+		SDL_DestroyCond(g_job_cond_start);
+	if (g_job_mutex != NULL)
+		SDL_DestroyMutex(g_job_mutex);
+	g_job_cond_done = NULL;
+	g_job_cond_start = NULL;
+	g_job_mutex = NULL;
+#endif
+
+	for (int i = 0; i < JOB_MAX; i++)
+	{
+		free(g_job[i].cmd);
+		g_job[i].cmd = NULL;
+		g_job[i].cmd_len_max = 0;
+	}
+}
+
+// Calls func for indexes 0 to len - 1 split into jobs, then calls the functions that the jobs passed to job_cmd()
+void job_run(JobFunc func, int len)
+{
+	if (g_job_threads == 0 || len < JOB_LEN_MIN * 2)
+	{
+		func(0, len);
+		return;
+	}
+
+#ifdef	JOB_ENABLED
+	SDL_LockMutex(g_job_mutex);
+
+	// Threads that woke up after the last jobs were finished can still be looking for jobs, and nothing they read can be changed until they stop
+	while (g_job_active > 0)
+		SDL_CondWait(g_job_cond_done, g_job_mutex);
+
+	// Split the range into jobs of nearly the same size
+	g_job_len = len / JOB_LEN_MIN;
+	if (g_job_len > JOB_MAX)
+		g_job_len = JOB_MAX;
+	for (int i = 0; i < g_job_len; i++)
+	{
+		g_job[i].start = (long) len * i / g_job_len;
+		g_job[i].end = (long) len * (i + 1) / g_job_len;
+		g_job[i].cmd_len = 0;
+	}
+	g_job_func = func;
+	g_job_ts = g_ts;
+	SDL_AtomicSet(&g_job_next, 0);
+	SDL_AtomicSet(&g_job_done, 0);
+
+	// Wake up the pool and help it
+	g_job_gen++;
+	SDL_CondBroadcast(g_job_cond_start);
+	SDL_UnlockMutex(g_job_mutex);
+	job_work();
+
+	SDL_LockMutex(g_job_mutex);
+	while (SDL_AtomicGet(&g_job_done) < g_job_len || g_job_active > 0)
+		SDL_CondWait(g_job_cond_done, g_job_mutex);
+	SDL_UnlockMutex(g_job_mutex);
+#endif
+
+	// Run the stored commands in the order they would have been stored in on one thread
+	for (int i = 0; i < g_job_len; i++)
+		for (int j = 0; j < g_job[i].cmd_len; j++)
+			g_job[i].cmd[j].func(g_job[i].cmd[j].ptr);
+}
+
+// Calls func(ptr) on the main thread once every job of the current job_run() call is finished if it's called from a job, or right away otherwise
+void job_cmd(JobCmdFunc func, void *ptr)
+{
+	Job *job = g_job_cur;
+	if (job == NULL)
+	{
+		func(ptr);
+		return;
+	}
+
+	if (job->cmd_len == job->cmd_len_max)
+	{
+		const int len_max = job->cmd_len_max == 0 ? JOB_CMD_LEN_MIN : job->cmd_len_max * 2;
+		JobCmd *cmd = realloc(job->cmd, sizeof(JobCmd) * len_max);
+		if (cmd == NULL)
+		{
+			PERR("failed to allocate mem for job command buffer");
+			return;
+		}
+		job->cmd = cmd;
+		job->cmd_len_max = len_max;
+	}
+	job->cmd[job->cmd_len++] = (JobCmd) {func, ptr};
+}
+
+// Returns the # of threads in the pool, not counting the main thread
+int job_threads(void)
+{
+	return g_job_threads;
+}
+
+#ifdef	JOB_ENABLED
+// Function run by the threads of the pool
+static int job_thread(void *data)
+{
+	unsigned int gen = 0;
+	SDL_LockMutex(g_job_mutex);
+	for (;;)
+	{
+		while (!g_job_stop && gen == g_job_gen)
+			SDL_CondWait(g_job_cond_start, g_job_mutex);
+		if (g_job_stop)
+			break;
+		gen = g_job_gen;
+		g_job_active++;
+		SDL_UnlockMutex(g_job_mutex);
+
+		g_ts = g_job_ts;
+		job_work();
+
+		SDL_LockMutex(g_job_mutex);
+		g_job_active--;
+		SDL_CondSignal(g_job_cond_done);
+	}
+	SDL_UnlockMutex(g_job_mutex);
+	return 0;
+}
+
+// Takes and works on jobs until there are none left
+static void job_work(void)
+{
+	int i;
+	while ((i = SDL_AtomicAdd(&g_job_next, 1)) < g_job_len)
+	{
+		g_job_cur = &g_job[i];
+		g_job_func(g_job[i].start, g_job[i].end);
+		g_job_cur = NULL;
+		SDL_AtomicAdd(&g_job_done, 1);
+	}
+}
+#endif
@@ -0,0 +1,49 @@
+/*
+ * job.h contains the job pool, which spreads work over several threads.
+ *
+ * job_run() splits a range of indexes (like the entities in an entity array) into jobs, which are worked on by the pool's threads and the main thread until none are left. Threads take the next job that hasn't been started whenever they finish one, so threads that get slow jobs don't hold the others up. job_run() returns once every job is finished.
+ *
+ * Jobs can't change anything shared between threads, like entity arrays, particles or the random number generator. Instead, they pass functions that do those things to job_cmd(), which stores them in a command buffer for the job. When every job is finished, job_run() calls the stored functions on the main thread in the order of the jobs they came from, so they happen in the same order they would if there were only one thread, and the results don't depend on which threads ran which jobs.
+ */
+
+#ifndef	JOB_H
+#define	JOB_H
+
+// If defined, job_init() starts threads for the job pool, otherwise jobs are run on the main thread as soon as they're added
+#ifndef	__EMSCRIPTEN__
+	#define	JOB_ENABLED
+#endif
+
+// Max # of threads in the pool, not counting the main thread
+#define	JOB_THREADS_MAX	7
+
+// Max # of jobs job_run() splits its range into
+#define	JOB_MAX		64
+
+// Min # of indexes in a job
+// Ranges shorter than twice this are run on the main thread without splitting them into jobs, because waking up the pool would take longer than the work
+#define	JOB_LEN_MIN	512
+
+// Function that does the work for indexes start to end - 1
+typedef void (*JobFunc)(int start, int end);
+
+// Function stored in a command buffer by job_cmd(), which is given the pointer stored with it
+typedef void (*JobCmdFunc)(void *ptr);
+
+// Starts the threads of the job pool
+// Returns nonzero on error
+int job_init(void);
+
+// Stops the threads of the job pool and frees command buffers
+void job_quit(void);
+
+// Calls func for indexes 0 to len - 1 split into jobs, then calls the functions that the jobs passed to job_cmd()
+void job_run(JobFunc func, int len);
+
+// Calls func(ptr) on the main thread once every job of the current job_run() call is finished if it's called from a job, or right away otherwise
+void job_cmd(JobCmdFunc func, void *ptr);
+
+// Returns the # of threads in the pool, not counting the main thread
+int job_threads(void);
+
+#endif
@@ -7,7 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>	// For rand()
 #include <time.h>	// For setting random seed
-#include <string.h>	// For strncmp()
+#include <string.h>	// For strncmp() & strcmp()
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
@@ -16,24 +16,33 @@
 #include <emscripten.h>
 #endif
 
-#include "barrier.h"
+#include "bench.h"
 #include "camera.h"
 #include "editor/editor.h"
 #include "editor/draw.h"
 #include "entity/all.h"
 #include "error.h"
 #include "font.h"
+#include "genmap.h"
 #include "hud.h"
 #include "init.h"
 #include "input.h"
 #include "map.h"
+#include "map_bin.h"
+#include "pace.h"
+#include "particle.h"
+#include "prof.h"
 #include "random.h"
+#include "replay.h"
+#include "sim.h"
 #include "sound.h"
 #include "texture.h"
 #include "tile/data.h"
 #include "tile/draw.h"
 #include "tile/outside.h"
+#include "tile/plane.h"
 #include "timestep.h"
+#include "trace.h"
 #include "util/string.h"
 #include "video.h"
 
@@ -49,10 +58,6 @@ static GameState g_game_state;
 // Event for handling input
 static SDL_Event g_sdlev;
 
-// Game ticks for handling timestep
-static uint32_t g_tick_last_frame = 0;
-static uint32_t g_tick_this_frame = 0;
-
 // The standard game loop
 static inline void game_loop_standard(void);
 
@@ -72,6 +77,38 @@ int main(int argc, char **argv)
 	// True if the first map will be edited
 	bool ed_init = false;
 
+	// Path of the file to record player input to, or NULL if input isn't being recorded
+	char *record_path = NULL;
+
+	// Launch modes that run without the game loop
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+		return bench_main(argc - 2, argv + 2) ? EXIT_FAILURE : EXIT_SUCCESS;
+	if (argc > 1 && strcmp(argv[1], "--bench-suite") == 0)
+		return bench_suite_main(argc - 2, argv + 2) ? EXIT_FAILURE : EXIT_SUCCESS;
+	if (argc > 1 && strcmp(argv[1], "--genmap") == 0)
+		return genmap_main(argc - 2, argv + 2) ? EXIT_FAILURE : EXIT_SUCCESS;
+	if (argc > 1 && strcmp(argv[1], "--replay") == 0)
+		return bench_replay_main(argc - 2, argv + 2) ? EXIT_FAILURE : EXIT_SUCCESS;
+	if (argc > 1 && strcmp(argv[1], "--sizes") == 0)
+		return bench_sizes_main(argc - 2, argv + 2) ? EXIT_FAILURE : EXIT_SUCCESS;
+	if (argc > 1 && strcmp(argv[1], "--map2bin") == 0)
+		return map_bin_convert_main(argc - 2, argv + 2, true) ? EXIT_FAILURE : EXIT_SUCCESS;
+	if (argc > 1 && strcmp(argv[1], "--bin2map") == 0)
+		return map_bin_convert_main(argc - 2, argv + 2, false) ? EXIT_FAILURE : EXIT_SUCCESS;
+
+	// Recording input takes the file path from the arguments, the rest are handled as usual
+	if (argc > 1 && strcmp(argv[1], "--record") == 0)
+	{
+		if (argc < 3 || argc > 4)
+		{
+			PERR("usage: --record <file> [map]");
+			return EXIT_FAILURE;
+		}
+		record_path = argv[2];
+		argc -= 2;
+		argv += 2;
+	}
+
 	switch (argc)
 	{
 	case 1:
@@ -80,13 +117,17 @@ int main(int argc, char **argv)
 		goto l_normal_startup;
 	case 2:
 		// Game is launched with the map from argv[1]
+		// The map is played instead of edited when input is being recorded
 		map_start = argv[1];
-		g_game_state = GAMESTATE_EDITOR;
-		ed_init = true;
+		if (record_path == NULL)
+		{
+			g_game_state = GAMESTATE_EDITOR;
+			ed_init = true;
+		}
 	l_normal_startup:
 		if (game_init_all())
 			return EXIT_FAILURE;
-		if (map_load_txt(map_start, ed_init))
+		if (TRACE_INT("map_load", map_load(map_start, ed_init)))
 		{
 			game_quit_all();
 			return EXIT_FAILURE;
@@ -136,7 +177,7 @@ int main(int argc, char **argv)
 			game_quit_all();
 			return EXIT_FAILURE;
 		}
-		if ((g_tile_map = (TileId **) map_alloc(g_map.width, g_map.height, sizeof(TileId))) == NULL)
+		if (map_grid_alloc(&g_tile_map, g_map.width, g_map.height, TILE_AIR) || tile_plane_build())
 		{
 			game_quit_all();
 			return EXIT_FAILURE;
@@ -154,6 +195,16 @@ int main(int argc, char **argv)
 	// Spawn clouds
 	ent_cloud_update_count();
 
+	if (record_path != NULL && replay_record_start(record_path))
+	{
+		game_quit_all();
+		return EXIT_FAILURE;
+	}
+
+	// Start simulating and timing frames from now
+	ts_reset();
+	pace_reset();
+
 	// Game loops
 #ifdef	__EMSCRIPTEN__
 	// Emscripten way of handling game loops
@@ -178,6 +229,10 @@ int main(int argc, char **argv)
 	}
 #endif
 
+	replay_stop();
+	prof_quit();
+	trace_write();
+	pace_report();
 	game_quit_all();
 	return EXIT_SUCCESS;
 }
@@ -216,11 +271,10 @@ static void game_loop_standard(void)
 {
 	//static double timestep_reset = 1.0;
 
-	// Set frame start ticks
-	g_tick_this_frame = SDL_GetTicks();
-	g_tick_last_frame = g_tick_this_frame;
+	PROF_START(PROF_FRAME);
 
 	// Handle SDL events
+	PROF_START(PROF_EVENTS);
 	while (SDL_PollEvent(&g_sdlev) != 0)
 	{
 		// User requests quit
@@ -232,7 +286,19 @@ static void game_loop_standard(void)
 		case SDL_KEYDOWN:
 			switch (g_sdlev.key.keysym.sym)
 			{
+			case SDLK_F3:
+				prof_toggle_overlay();
+				break;
+			case SDLK_F4:
+				prof_toggle_csv();
+				break;
+			case SDLK_F5:
+				trace_write();
+				break;
 			case SDLK_e:
+				// The editor can change the map, which a replay can't play back
+				if (g_replay_state == REPLAY_RECORDING)
+					break;
 				g_game_state = GAMESTATE_EDITOR;
 				if (maped_init())
 					g_game_state = GAMESTATE_QUIT;
@@ -241,17 +307,22 @@ static void game_loop_standard(void)
 				g_game_state = GAMESTATE_QUIT;
 				break;
 			// Test actions
+			// Scaling the screen changes its dimensions, which a replay can't play back
 			case SDLK_1:
-				screen_scale(1, 1);
+				if (g_replay_state != REPLAY_RECORDING)
+					screen_scale(1, 1);
 				break;
 			case SDLK_2:
-				screen_scale(2, 2);
+				if (g_replay_state != REPLAY_RECORDING)
+					screen_scale(2, 2);
 				break;
 			case SDLK_3:
-				screen_scale(g_screen_xscale - 0.1f, g_screen_yscale - 0.1f);
+				if (g_replay_state != REPLAY_RECORDING)
+					screen_scale(g_screen_xscale - 0.1f, g_screen_yscale - 0.1f);
 				break;
 			case SDLK_4:
-				screen_scale(g_screen_xscale + 0.1f, g_screen_yscale + 0.1f);
+				if (g_replay_state != REPLAY_RECORDING)
+					screen_scale(g_screen_xscale + 0.1f, g_screen_yscale + 0.1f);
 				break;
 			/*
 			case SDLK_5:
@@ -267,32 +338,31 @@ static void game_loop_standard(void)
 				break;
 			*/
 			}
-			ent_player_keydown(g_sdlev.key.keysym.sym);
+			input_queue_keydown(g_sdlev.key.keysym.sym);
 			break;
 		case SDL_WINDOWEVENT:
 			switch (g_sdlev.window.event)
 			{
 			case SDL_WINDOWEVENT_SIZE_CHANGED:
+				// The window can't be kept from resizing, so end the recording on the last frame with the recorded screen dimensions
+				if (g_replay_state == REPLAY_RECORDING)
+				{
+					PINF("window resized, stopping the recording");
+					replay_stop();
+				}
 				screen_update_dimensions();
 				break;
 			}
 			break;
 		}
 	}
+	PROF_STOP(PROF_EVENTS);
 
-	// Update test objects
-	ent_player_update();
-	cam_update_shifts();
-	ENT_UPDATE(FIREBALL);
-	ENT_UPDATE(EVILBALL);
-	ENT_UPDATE(PARTICLE);
-	ENT_UPDATE(RAGDOLL);
-	ENT_UPDATE(GROUNDGUY);
-	ENT_UPDATE(CLOUD);
-	ENT_UPDATE(SLIDEGUY);
-	ENT_UPDATE(TURRET);
-	ENT_UPDATE(COOLEGG);
-	barrier_handle_check_requests();
+	// Simulate as many ticks as the real time passed since the last frame allows, then draw everything between the last two ticks
+	ts_accumulate();
+	while (ts_tick())
+		sim_update();
+	cam_lerp_shifts();
 
 	// Clear the screen
 	SDL_SetRenderDrawColor(g_renderer, 180, 255, 230, 255);
@@ -301,14 +371,20 @@ static void game_loop_standard(void)
 	ENT_DRAW(CLOUD);
 
 	// Draw all tiles
+	PROF_START(PROF_TILES);
 	tile_draw_all();
+	PROF_STOP(PROF_TILES);
+	PROF_START(PROF_TILES_OUTSIDE);
 	tile_draw_outside_all();
+	PROF_STOP(PROF_TILES_OUTSIDE);
 
 	// Render test objects
 	ENT_DRAW(DOOR);
 	ENT_DRAW(TURRET);
 	ENT_DRAW(ITEM);
-	ENT_DRAW(PARTICLE);
+	PROF_START(PROF_PTCL_DRAW);
+	ptcl_draw_all();
+	PROF_STOP(PROF_PTCL_DRAW);
 	ENT_DRAW(RAGDOLL);
 	ENT_DRAW(GROUNDGUY);
 	ENT_DRAW(SLIDEGUY);
@@ -317,25 +393,26 @@ static void game_loop_standard(void)
 	ENT_DRAW(SAVEBIRD);
 	ENT_DRAW(BARRIER);
 	ENT_DRAW(COOLEGG);
+	PROF_START(PROF_PLAYER_DRAW);
 	if (g_player.hp > 0)
 		ent_player_draw();
+	PROF_STOP(PROF_PLAYER_DRAW);
 
 	// Draw HUD
+	PROF_START(PROF_HUD);
 	hud_draw_all();
+	PROF_STOP(PROF_HUD);
+	prof_draw();
 
 	// Render what's currently on the screen
+	PROF_START(PROF_PRESENT);
 	SDL_RenderPresent(g_renderer);
+	PROF_STOP(PROF_PRESENT);
+	PROF_STOP(PROF_FRAME);
+	prof_frame_end();
 
-#ifndef	__EMSCRIPTEN__
-	if (!g_vsync)
-	{
-		// Manually delay the program if VSYNC is disabled
-		// Not needed on emscripten because we control the framerate when calling emscripten_set_main_loop_arg()
-		uint32_t tick_diff = SDL_GetTicks() - g_tick_this_frame;
-		if (tick_diff < g_no_vsync_frame_ticks)
-			SDL_Delay(g_no_vsync_frame_ticks - tick_diff);
-	}
-#endif
+	// Wait for the next frame if VSYNC is disabled
+	pace_frame_end();
 }
 
 // The map editor game loop
@@ -351,10 +428,6 @@ static inline void game_loop_editor(void)
 		.alt = false,
 	};
 
-	// Set frame start ticks
-	g_tick_this_frame = SDL_GetTicks();
-	g_tick_last_frame = g_tick_this_frame;
-
 	// Handle SDL events
 	while (SDL_PollEvent(&g_sdlev) != 0)
 	{
@@ -374,6 +447,9 @@ static inline void game_loop_editor(void)
 					break;
 				}
 				g_game_state = GAMESTATE_INGAME;
+
+				// Don't simulate the time spent in the editor
+				ts_reset();
 				break;
 			case SDLK_q:
 				g_game_state = GAMESTATE_QUIT;
@@ -435,14 +511,6 @@ static inline void game_loop_editor(void)
 	// Render what's currently on the screen
 	SDL_RenderPresent(g_renderer);
 
-#ifndef	__EMSCRIPTEN__
-	if (!g_vsync)
-	{
-		// Manually delay the program if VSYNC is disabled
-		// Not needed on emscripten because we control the framerate when calling emscripten_set_main_loop_arg()
-		uint32_t tick_diff = SDL_GetTicks() - g_tick_this_frame;
-		if (tick_diff < g_no_vsync_frame_ticks)
-			SDL_Delay(g_no_vsync_frame_ticks - tick_diff);
-	}
-#endif
+	// Wait for the next frame if VSYNC is disabled
+	pace_frame_end();
 }
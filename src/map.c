@@ -20,7 +20,11 @@
 #include "error.h"
 #include "fileio.h"
 #include "map.h"
+#include "map_bin.h"
+#include "particle.h"
 #include "tile/data.h"
+#include "tile/plane.h"
+#include "timestep.h"
 #include "util/string.h"
 #include "void_rect.h"
 
@@ -30,9 +34,6 @@
 // Used in map files to denote a map option specification
 #define	MAP_OPT_SYMBOL	'>'
 
-// Default outside tile value
-#define	MAP_DEF_OT	TILE_LIME
-
 // Length of string used to store current map option being read
 #define	MAP_OPTION_LEN	5
 
@@ -42,6 +43,42 @@
 // Info about the current map loaded
 MapInfo g_map;
 
+// Tile ids and entity tile ids are stored in map memory as MapCell values
+_Static_assert(TILE_MAX <= UINT8_MAX + 1 && ENT_TILE_MAX <= UINT8_MAX + 1, "tile ids must fit in a MapCell");
+
+// Shared chunks of map memory for each empty value, filled the first time they're used
+static MapChunk map_chunk_shared[UINT8_MAX + 1];
+static bool map_chunk_shared_ready[UINT8_MAX + 1];
+
+// Tile ids and entity tile ids of each map char, -1 if no tile or entity tile uses the char
+static int16_t map_char_tile[UINT8_MAX + 1];
+static int16_t map_char_ent[UINT8_MAX + 1];
+static bool map_char_ready = false;
+
+// Fills map_char_tile and map_char_ent
+static void map_char_build(void)
+{
+	for (int i = 0; i <= UINT8_MAX; i++)
+		map_char_tile[i] = map_char_ent[i] = -1;
+
+	// Go backwards so that the first tile with a char is the one found, like a linear search would
+	for (int i = TILE_MAX - 1; i >= 0; i--)
+		map_char_tile[(unsigned char) g_tile_md[i].map_char] = i;
+	for (int i = ENT_TILE_MAX - 1; i >= 0; i--)
+		map_char_ent[(unsigned char) g_ent_tile[i].map_char] = i;
+	map_char_ready = true;
+}
+
+// Frees the lines of a text map read into memory
+static void map_data_free(char **map_data, int map_height)
+{
+	if (map_data == NULL)
+		return;
+	for (int y = 0; y < map_height; ++y)
+		free(map_data[y]);
+	free(map_data);
+}
+
 // Returns nonzero on error
 static int map_read_line(char *dest, int expected_width, FILE *map_file)
 {
@@ -84,7 +121,7 @@ ErrCode map_load_txt(char *path, bool editing)
 		char **map_data = NULL;
 
 		// Contains entities from **map_data
-		EntTileId **ent_tile_data = NULL;
+		MapGrid ent_tile_data = {.chunk = NULL};
 
 	// Getting the full path from the path argument
 	char fullpath[RES_PATH_MAX];
@@ -99,13 +136,14 @@ ErrCode map_load_txt(char *path, bool editing)
 	// Begin to read the map tile data into memory
 	
 	// Buffer used to read a line of text from the map
-	char *map_line = malloc((MAP_WIDTH_MAX + 1) * sizeof(char));
+	// spdl_readstr() needs room for the \0 and one more char to find the end of a line that's MAP_WIDTH_MAX chars long
+	char *map_line = malloc((MAP_WIDTH_MAX + 2) * sizeof(char));
 
 	// Read the first line of text from the map INCLUDING \0
 	// Get the map width from the return value of spdl_readstr()
 	int map_width = spdl_readstr(
 		map_line,
-		MAP_WIDTH_MAX + 1,
+		MAP_WIDTH_MAX + 2,
 		'\n',
 		map_file
 	);
@@ -170,8 +208,10 @@ ErrCode map_load_txt(char *path, bool editing)
 	}
 
 	// Since the loop exited normally, MAP_HEIGHT_MAX was read
-	// This will cause lines beyond the max height to not be read, which could be an error
-	PERR("maximum height for a map was read in");
+	// This will cause lines beyond the max height to not be read, which is an error unless options come next
+	if ((c = fgetc(map_file)) != MAP_OPT_SYMBOL)
+		PERR("maximum height for a map was read in");
+	ungetc(c, map_file);
 
 l_heightloop_exit:
 	// Resize **map_data to the proper height
@@ -190,60 +230,18 @@ l_heightloop_exit:
 	// If an error occurs after this point, it is non-recoverable
 	err_code = ERR_NO_RECOVER;
 
-	// Free old map data
-	map_free(g_map.height, g_tile_map);
-	map_free(g_map.height, g_ent_map);
-	g_ent_map = NULL;
-	
-	// Allocate new space for the old maps
-	g_tile_map = map_alloc(map_width, map_height, sizeof(TileId));
-	if (g_tile_map == NULL)
-	{
-		PERR("failed to allocate mem for tile map");
+	if (map_load_begin(path, editing, map_width, map_height))
 		goto l_exit;
-	}
-	g_ent_map = map_alloc(map_width, map_height, sizeof(EntTile));
-	if (g_ent_map == NULL)
-	{
-		PERR("failed to allocate mem for entity map");
-		goto l_exit;
-	}
-
-	// Set the global values for map width and height
-	g_map.width = map_width;
-	g_map.height = map_height;
-
-	// Update misc game systems
-	
-	// Update g_map
-	strncpy(g_map.path, path, MAP_PATH_MAX);
-	g_map.editing = editing;
-	g_map.vr_list.len = 0;
-	
-	// Destroy leftover entities from last map
-	ent_destroy_temp();
-
-	// Scatter clouds across the screen
-	ent_cloud_scatter();
-
-	// Stop player from entering a door right away
-	g_player.door_stop = true;
-
-	// Update camera limits to reflect new map width and height
-	cam_update_limits();
 
 	// Create *ent_tile_data
 	// This stores chars used to represent entity tiles
-	ent_tile_data = map_alloc(g_map.width, g_map.height, sizeof(EntTileId));
-	if (ent_tile_data == NULL)
-	{
-		PERR("failed to allocate mem for ent_tile_data");
+	if (map_grid_alloc(&ent_tile_data, g_map.width, g_map.height, ENT_TILE_NONE))
 		goto l_exit;
-	}
 
 	// Read **map_data
-	// Copy tile data to **g_tile_map
-	// Copy entity tile data to **ent_tile_data
+	// Copy tile data to g_tile_map
+	// Copy entity tile data to ent_tile_data
+	// Both start out empty, so only tiles that aren't air and entity tiles are set
 	for (int y = 0; y < g_map.height; ++y)
 	{
 		for (int x = 0; x < g_map.width; ++x)
@@ -258,24 +256,24 @@ l_heightloop_exit:
 				if (ei == -1)
 				{
 					PERR("no tile or entity found at (%d, %d)", x, y);
-					g_tile_map[y][x] = TILE_AIR;
-					ent_tile_data[y][x] = ENT_TILE_NONE;
 				}
 				else
 				{
 					// Entity found
-					g_tile_map[y][x] = TILE_AIR;
-					ent_tile_data[y][x] = ei;
+					if (map_grid_set(&ent_tile_data, x, y, ei))
+						goto l_exit;
 				}
 			}
 			else
 			{
 				// Tile found
-				g_tile_map[y][x] = ti;
-				ent_tile_data[y][x] = ENT_TILE_NONE;
+				if (map_grid_set(&g_tile_map, x, y, ti))
+					goto l_exit;
 			}
 		}
 	}
+	if (tile_plane_build())
+		goto l_exit;
 
 	// Begin to read map options
 	while ((c = fgetc(map_file)) == MAP_OPT_SYMBOL)
@@ -411,7 +409,7 @@ l_heightloop_exit:
 			int y, x;
 			char c;
 			fscanf(map_file, "%d %d %c\n", &y, &x, &c);
-			ent_tile_data[y][x] = map_get_ent_id(c);
+			map_grid_set(&ent_tile_data, x, y, map_get_ent_id(c));
 		}
 		else
 		{
@@ -433,33 +431,97 @@ l_heightloop_exit:
 	else
 		map_file = NULL;
 
+	if (map_load_end(&ent_tile_data, editing))
+		goto l_exit;
+
+	// Map loaded successfully
+	err_code = ERR_NONE;
+
+l_exit:
+	// Free map_data and ent_tile_data and close map_file
+	map_data_free(map_data, map_height);
+	map_grid_free(&ent_tile_data);
+	if (map_file != NULL)
+		if (fclose(map_file))
+			PERR("failed to close map file");
+	return err_code;
+}
+
+// Frees the map memory of the last map, allocates map memory for a new map, and resets game systems for the new map
+// Map loaders call this once a map file has been read, returns nonzero on error
+int map_load_begin(const char *path, bool editing, int map_width, int map_height)
+{
+	// Free old map data
+	map_grid_free(&g_tile_map);
+	map_grid_free(&g_ent_map);
+	
+	// Allocate new space for the old maps
+	if (map_grid_alloc(&g_tile_map, map_width, map_height, TILE_AIR))
+		return 1;
+
+	// The entity map is only used by the editor
+	if (editing)
+	{
+		if (map_grid_alloc(&g_ent_map, map_width, map_height, ENT_TILE_NONE))
+			return 1;
+	}
+
+	// Set the global values for map width and height
+	g_map.width = map_width;
+	g_map.height = map_height;
+
+	// Update misc game systems
+	
+	// Update g_map
+	strncpy(g_map.path, path, MAP_PATH_MAX);
+	g_map.editing = editing;
+	g_map.vr_list.len = 0;
+	
+	// Destroy leftover entities & particles from last map
+	ent_destroy_temp();
+	ptcl_reset();
+
+	// Scatter clouds across the screen
+	ent_cloud_scatter();
+
+	// Stop player from entering a door right away
+	g_player.door_stop = true;
+
+	// Update camera limits to reflect new map width and height
+	cam_update_limits();
+
+	return 0;
+}
+
+// Spawns the entities of a new map from *ent_tile_data
+// Map loaders call this once the tiles and options of a map are set, returns nonzero on error
+// When not editing, *ent_tile_data is given to the collector and replaced with a copy, so the caller only has to free *ent_tile_data
+int map_load_end(MapGrid *ent_tile_data, bool editing)
+{
 	// Use entity tile data from the collector if it's possible
 	// Don't do this when editing a map
 	if (!editing)
 	{
-		// The current data in **ent_tile_data will be sent to the collector, so a duplicate of that data is needed so that we can write changes to it when spawning entities that doesn't effect the data in the collector
+		// The current data in *ent_tile_data will be sent to the collector, so a duplicate of that data is needed so that we can write changes to it when spawning entities that doesn't effect the data in the collector
 		// For now, we just need to create space for the duplicate data
-		EntTileId **new_ent_tile_data = map_alloc(map_width, map_height, sizeof(EntTileId));
-		if (new_ent_tile_data == NULL)
-		{
-			PERR("failed to allocate mem for new_ent_tile_data");
-			goto l_exit;
-		}
+		MapGrid new_ent_tile_data;
+		if (map_grid_alloc(&new_ent_tile_data, g_map.width, g_map.height, ENT_TILE_NONE))
+			return 1;
 
 		// Create a collector map data object to send to the collector
 		ColMapData cmd = {
 			.path = strndup(g_map.path, MAP_PATH_MAX),
-			.width = map_width,
-			.height = map_height,
-			.map = ent_tile_data,
+			.width = g_map.width,
+			.height = g_map.height,
+			.map = *ent_tile_data,
 		};
 
 		// Check if a memory error occured when duplicating g_map.path
 		if (cmd.path == NULL)
 		{
 			PERR("failed to duplicate g_map.path");
-			map_free(map_height, new_ent_tile_data);
-			goto l_exit;
+			map_grid_free(&new_ent_tile_data);
+			return 1;
 		}
 
 		// Attempt to add the loaded map data to the collector
@@ -468,11 +530,11 @@ l_heightloop_exit:
 		{
 			// Map was already added
 			
-			// Free current ent_tile_data
+			// Free current *ent_tile_data
 			// It is no longer needed because we will be using the tile data from the collector instead
-			map_free(map_height, ent_tile_data);
+			map_grid_free(ent_tile_data);
 
-			// Use ent_tile_data from the collector
+			// Use *ent_tile_data from the collector
 			g_col.active_index = dup_index;
 		}
 		else
@@ -482,13 +544,14 @@ l_heightloop_exit:
 		}
 
 		// Copy entity tile data from the collector to use to spawn entities
-		map_copy(map_width, map_height, sizeof(EntTileId), new_ent_tile_data, g_col.data[g_col.active_index].map);
-		ent_tile_data = new_ent_tile_data;
+		*ent_tile_data = new_ent_tile_data;
+		if (map_grid_copy(ent_tile_data, &g_col.data[g_col.active_index].map))
+			return 1;
 	}
 
-	// Read and write to **ent_tile_data
+	// Read and write to *ent_tile_data
 	// Call entity spawners
-	// If editing a map, copy editable entity tile data to **g_ent_map
+	// If editing a map, copy editable entity tile data to g_ent_map
 	
 	// Spawn entities in void rectangles
 	for (int i = 0; i < g_map.vr_list.len; ++i)
@@ -498,7 +561,7 @@ l_heightloop_exit:
 		{
 			for (int x = r->rect.x; x < r->rect.x + r->rect.w; ++x)
 			{
-				EntTileId ei = ent_tile_data[y][x];
+				EntTileId ei = map_grid_get(ent_tile_data, x, y);
 				if (ei == ENT_TILE_NONE)
 					continue;
 
@@ -513,13 +576,10 @@ l_heightloop_exit:
 					
 				// Add the entity to the entity tile map
 				if (editing)
-				{
-					g_ent_map[y][x].active = true;
-					g_ent_map[y][x].etid = ei;
-				}
+					map_grid_set(&g_ent_map, x, y, ei);
 
-				// Overwrite the entity tile at the entity position so the entity isn't spawned again by the next loop through **ent_tile_data
-				ent_tile_data[y][x] = ENT_TILE_NONE;
+				// Overwrite the entity tile at the entity position so the entity isn't spawned again by the next loop through *ent_tile_data
+				map_grid_set(ent_tile_data, x, y, ENT_TILE_NONE);
 			}
 		}
 	}
@@ -533,7 +593,14 @@ l_heightloop_exit:
 	{
 		for (int x = 0; x < g_map.width; ++x)
 		{
-			EntTileId ei = ent_tile_data[y][x];
+			// Skip the rest of this row of a chunk with no entity tiles
+			if (map_grid_chunk_is_shared(ent_tile_data, x, y))
+			{
+				x |= MAP_CHUNK_MASK;
+				continue;
+			}
+
+			EntTileId ei = map_grid_get(ent_tile_data, x, y);
 			if (ei == ENT_TILE_NONE)
 				continue;
 
@@ -541,37 +608,43 @@ l_heightloop_exit:
 				PERR("entity tile spawner for entity id %d (%s) failed at (%d, %d)", ei, g_ent_tile[ei].name, x, y);
 
 			if (editing)
-			{
-				g_ent_map[y][x].active = true;
-				g_ent_map[y][x].etid = ei;
-			}
+				map_grid_set(&g_ent_map, x, y, ei);
 		}
 	}
 
 	// Move the player to the door with the last id used
-	EntDOOR *e = g_er[ENT_ID_DOOR]->e;
 	for (EntDoorId i = 0; i < g_er[ENT_ID_DOOR]->len; i++)
 	{
+		EntDOOR *e = ENT_ARRAY_AT(g_er[ENT_ID_DOOR], i);
 		if (e->did == g_ent_door_last_used)
 		{
 			g_player.b.x = e->b.x;
 			g_player.b.y = e->b.y;
 			break;
 		}
-		++e;
 	}
 
-	// Map loaded successfully
-	err_code = ERR_NONE;
+	// Don't draw anything between its positions on the old and new map
+	ts_skip_lerp();
 
-l_exit:
-	// Free map_data and ent_tile_data and close map_file
-	map_free(map_height, map_data);
-	map_free(map_height, ent_tile_data);
-	if (map_file != NULL)
-		if (fclose(map_file))
-			PERR("failed to close map file");
-	return err_code;
+	return 0;
+}
+
+// Loads a map from a text file, or from a binary map file if path ends in MAP_BIN_EXT (see map_bin.h)
+// The editing parameter is true when the map is being opened for editing
+ErrCode map_load(char *path, bool editing)
+{
+	if (map_bin_path(path))
+		return map_load_bin(path, editing);
+	return map_load_txt(path, editing);
+}
+
+// Saves a map to a text file, or to a binary map file if path ends in MAP_BIN_EXT, returns nonzero on error
+int map_save(char *path)
+{
+	if (map_bin_path(path))
+		return map_save_bin(path);
+	return map_save_txt(path);
 }
 
 // Saves a map to a text file, returns nonzero on error
@@ -603,13 +676,15 @@ int map_save_txt(char *path)
 	{
 		for (int x = 0; x < g_map.width; x++)
 		{
-			if (g_ent_map[y][x].active)
+			const EntTileId ei = map_grid_get(&g_ent_map, x, y);
+			const TileId ti = map_grid_get(&g_tile_map, x, y);
+			if (ei != ENT_TILE_NONE)
 			{
 				// Don't spawn barriers with entity options
-				if (g_tile_map[y][x] != TILE_AIR && g_ent_map[y][x].etid != ENT_TILE_BARRIER)
+				if (ti != TILE_AIR && ei != ENT_TILE_BARRIER)
 				{
 					// Write a tile
-					fputc(g_tile_md[g_tile_map[y][x]].map_char, map_file);
+					fputc(g_tile_md[ti].map_char, map_file);
 
 					// Add to entity option data
 					if (ent_opt_list.len >= ENT_OPT_LEN)
@@ -624,13 +699,13 @@ int map_save_txt(char *path)
 				else
 				{
 					// Write an entity
-					fputc(g_ent_tile[g_ent_map[y][x].etid].map_char, map_file);
+					fputc(g_ent_tile[ei].map_char, map_file);
 				}
 			}
 			else
 			{
 				// Write a tile
-				fputc(g_tile_md[g_tile_map[y][x]].map_char, map_file);
+				fputc(g_tile_md[ti].map_char, map_file);
 			}
 		}
 		fprintf(map_file, "\n");
@@ -642,6 +717,13 @@ int map_save_txt(char *path)
 	fputc(MAP_OPT_SYMBOL, map_file);
 	fprintf(map_file, "ot %c\n", g_tile_md[g_tile_outside].map_char);
 
+	// Camera scroll stop
+	if (g_cam.scroll_stop)
+	{
+		fputc(MAP_OPT_SYMBOL, map_file);
+		fprintf(map_file, "ss 1\n");
+	}
+
 	// Door map paths
 	for (int i = 0; i < ENT_DOOR_MAX; ++i)
 	{
@@ -677,7 +759,7 @@ int map_save_txt(char *path)
 		int y = p->y;
 		int x = p->x;
 		fputc(MAP_OPT_SYMBOL, map_file);
-		fprintf(map_file, "e %d %d %c\n", y, x, g_ent_tile[g_ent_map[y][x].etid].map_char);
+		fprintf(map_file, "e %d %d %c\n", y, x, g_ent_tile[map_grid_get(&g_ent_map, x, y)].map_char);
 	}
 
 	if (fclose(map_file))
@@ -685,63 +767,140 @@ int map_save_txt(char *path)
 	return 0;
 }
 
-// Allocates and returns a pointer to map memory with size bytes for each index, returns NULL on error
-void *map_alloc(int map_width, int map_height, size_t size)
+// Returns the shared chunk with every cell set to empty
+static MapChunk *map_chunk_shared_get(MapCell empty)
 {
-	void **map_ptr;
+	if (!map_chunk_shared_ready[empty])
+	{
+		memset(map_chunk_shared[empty].cell, empty, sizeof(MapChunk));
+		map_chunk_shared_ready[empty] = true;
+	}
+	return &map_chunk_shared[empty];
+}
 
-	// Allocate mem for the y rows
-	if ((map_ptr = calloc(map_height, sizeof(void *))) == NULL)
+// Allocates map memory with every cell set to empty, returns nonzero on error
+int map_grid_alloc(MapGrid *g, int map_width, int map_height, MapCell empty)
+{
+	const int chunk_width = (map_width + MAP_CHUNK_MASK) >> MAP_CHUNK_SHIFT;
+	const int chunk_height = (map_height + MAP_CHUNK_MASK) >> MAP_CHUNK_SHIFT;
+	const size_t len = (size_t) chunk_width * chunk_height;
+	if ((g->chunk = malloc(len * sizeof(MapChunk *))) == NULL)
 	{
-		fprintf(stderr, "failed to allocate mem for map\n");
-		return NULL;
+		PERR("failed to allocate mem for map");
+		g->width = g->height = g->chunk_width = g->chunk_height = 0;
+		return 1;
 	}
 
-	// Allocate mem for the x columns
-	for (int y = 0; y < map_height; ++y)
+	// Every chunk starts out shared
+	g->shared = map_chunk_shared_get(empty);
+	for (size_t i = 0; i < len; ++i)
+		g->chunk[i] = g->shared;
+
+	g->width = map_width;
+	g->height = map_height;
+	g->chunk_width = chunk_width;
+	g->chunk_height = chunk_height;
+	g->empty = empty;
+	return 0;
+}
+
+// Frees map memory
+void map_grid_free(MapGrid *g)
+{
+	if (g->chunk != NULL)
 	{
-		if ((map_ptr[y] = calloc(map_width, size)) == NULL)
-		{
-			fprintf(stderr, "failed to allocate mem for map\n");
+		map_grid_clear(g);
+		free(g->chunk);
+		g->chunk = NULL;
+	}
+	g->width = g->height = g->chunk_width = g->chunk_height = 0;
+}
 
-			// Free all x tile id arrays allocated so far
-			for (int yy = y - 1; yy >= 0; --yy)
-				free(map_ptr[yy]);
-			free(map_ptr);
-			return NULL;
-		}
+// Sets a cell in a shared chunk of map memory, returns nonzero on error
+// Only map_grid_set() should call this
+int map_grid_set_shared(MapGrid *g, int x, int y, MapCell value)
+{
+	// Shared chunks already hold the empty value
+	if (value == g->empty)
+		return 0;
+
+	// Copy on write
+	MapChunk *own;
+	if ((own = malloc(sizeof(MapChunk))) == NULL)
+	{
+		PERR("failed to allocate mem for map chunk");
+		return 1;
 	}
+	memcpy(own, g->shared, sizeof(MapChunk));
+	own->cell[MAP_CHUNK_INDEX(x, y)] = value;
+	MAP_GRID_CHUNK(g, x, y) = own;
+	return 0;
+}
 
-	return (void *) map_ptr;
+// Sets every cell of map memory to its empty value
+void map_grid_clear(MapGrid *g)
+{
+	const size_t len = (size_t) g->chunk_width * g->chunk_height;
+	for (size_t i = 0; i < len; ++i)
+	{
+		if (g->chunk[i] != g->shared)
+		{
+			free(g->chunk[i]);
+			g->chunk[i] = g->shared;
+		}
+	}
 }
 
-// Frees map memory
-void map_free(int map_height, void *map_ptr_param)
+// Returns the # of bytes used by map memory
+size_t map_grid_mem_size(const MapGrid *g)
 {
-	// Use map pointer parameter as double pointer
-	void **map_ptr = (void **) map_ptr_param;
+	if (g->chunk == NULL)
+		return 0;
 
-	// Map never existed/was already freed
-	if (map_ptr == NULL)
-		return;
-	
-	// Free all x rows
-	for (int y = 0; y < map_height; ++y)
-		free(map_ptr[y]);
-	free(map_ptr);
+	// Only count chunks that aren't shared
+	const size_t len = (size_t) g->chunk_width * g->chunk_height;
+	size_t size = len * sizeof(MapChunk *);
+	for (size_t i = 0; i < len; ++i)
+		if (g->chunk[i] != g->shared)
+			size += sizeof(MapChunk);
+	return size;
 }
 
-// Copies map data from *src to *dest
-// For this to work, both *dest and *src must have the same width, height, and size
-void map_copy(int map_width, int map_height, size_t size, void *dest_param, void *src_param)
+// Returns the # of bytes used by the map memory of the current map
+size_t map_mem_size(void)
 {
-	// Use map pointer parameters as double pointers
-	void **dest = (void **) dest_param;
-	void **src = (void **) src_param;
+	return map_grid_mem_size(&g_tile_map) + map_grid_mem_size(&g_ent_map) + tile_plane_mem_size();
+}
 
-	// Copy rows
-	for (int i = 0; i < map_height; ++i)
-		memcpy(dest[i], src[i], map_width * size);
+// Copies map memory from *src to *dest, returns nonzero on error
+// For this to work, both *dest and *src must have the same width, height, and empty value
+int map_grid_copy(MapGrid *dest, const MapGrid *src)
+{
+	const size_t len = (size_t) src->chunk_width * src->chunk_height;
+	for (size_t i = 0; i < len; ++i)
+	{
+		if (src->chunk[i] == src->shared)
+		{
+			// Share the empty chunk instead of copying it
+			if (dest->chunk[i] != dest->shared)
+			{
+				free(dest->chunk[i]);
+				dest->chunk[i] = dest->shared;
+			}
+			continue;
+		}
+		if (dest->chunk[i] == dest->shared)
+		{
+			if ((dest->chunk[i] = malloc(sizeof(MapChunk))) == NULL)
+			{
+				PERR("failed to allocate mem for map chunk");
+				dest->chunk[i] = dest->shared;
+				return 1;
+			}
+		}
+		memcpy(dest->chunk[i], src->chunk[i], sizeof(MapChunk));
+	}
+	return 0;
 }
 
 // Returns false if two entities or tiles share the same map character, should be used in an assert
@@ -802,17 +961,15 @@ void map_vr_list_del(int index)
 // Returns the tile id of a character, -1 if no tile is matched
 int map_get_tile_id(char c)
 {
-	for (int i = 0; i < TILE_MAX; i++)
-		if (g_tile_md[i].map_char == c)
-			return i;
-	return -1;
+	if (!map_char_ready)
+		map_char_build();
+	return map_char_tile[(unsigned char) c];
 }
 
 // Returns the entity tile id of a character, -1 if no entity is matched
 int map_get_ent_id(char c)
 {
-	for (int i = 0; i < ENT_TILE_MAX; i++)
-		if (g_ent_tile[i].map_char == c)
-			return i;
-	return -1;
+	if (!map_char_ready)
+		map_char_build();
+	return map_char_ent[(unsigned char) c];
 }
@@ -25,24 +25,30 @@
  * 	3. Old map data is freed and reallocated to fit the new map dimensions
  * 	4. Various game systems are updated
  * 	5. The map options are read
- * 	6. Tiles from map_data are placed
+ * 	6. Tiles from map_data are placed and the tile flag bitplanes are built from them (see tile/plane.h)
  * 	7. A space for entity tile data is created with the ent_tile_data variable
  *	8. An attempt to add the map to the collector (see collector.h) is made. If the map was already added to the collector, copy the collector data to ent_tile_data.
  *	9. Entities in void rectangles are spawned from ent_tile_data
  *	10. The remaining entities that aren't in void rectangles are spawned from ent_tile_data
  *	11. The player is placed at the door from which they are entering the map, if there is one
  *
+ * Steps 3 and 4 are done by map_load_begin(), and steps 8 to 11 by map_load_end(), so that maps can also be loaded from the binary map format in map_bin.h. map_load() and map_save() pick the format from the file extension.
+ *
  * Map terminology:
  * 	tile data = data representing tiles defined in tile/data.c
  * 	entity tile data = data representing entity tiles defined in entity/tile.c
  * 	void rectangle = a data structure defined in void_rect.h
- * 	map memory = a 2d array accessed by [y][x], where y and x are tile coordinates in the game world
+ * 	map memory = a MapGrid, which is a grid of one byte cells read with map_grid_get(grid, x, y) and written with map_grid_set(grid, x, y, value), where y and x are tile coordinates in the game world
+ *
+ * Map memory is split into square chunks of MAP_CHUNK_SIZE by MAP_CHUNK_SIZE cells, found through a directory of chunk pointers. Every chunk starts out pointing to a shared chunk filled with the grid's empty value (air for tiles, ENT_TILE_NONE for entity tiles). A chunk gets its own memory the first time a cell in it is set to something else, so memory scales with what's in a map rather than its dimensions. Shared chunks must never be written to.
  */
 
 #ifndef	MAP_H
 #define	MAP_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "error.h"
 #include "void_rect.h"
@@ -54,6 +60,9 @@
 // The maximum length of g_map
 #define	MAP_PATH_MAX	20
 
+// Default outside tile value
+#define	MAP_DEF_OT	TILE_LIME
+
 // Maximum number of void rectangles that can be used in one map
 #define	VOID_RECT_LIST_LEN	20
 
@@ -80,6 +89,82 @@ typedef struct{
 // Info about the current map loaded
 extern MapInfo g_map;
 
+// A cell of map memory, which holds a tile id or entity tile id
+typedef uint8_t MapCell;
+
+// Log2 of the width and height of a map memory chunk in cells
+#define	MAP_CHUNK_SHIFT	4
+
+// Width and height of a map memory chunk in cells
+#define	MAP_CHUNK_SIZE	(1 << MAP_CHUNK_SHIFT)
+
+// Mask to get a cell's position within its chunk
+#define	MAP_CHUNK_MASK	(MAP_CHUNK_SIZE - 1)
+
+// A square of cells in map memory, stored row after row
+typedef struct{
+	MapCell cell[MAP_CHUNK_SIZE * MAP_CHUNK_SIZE];
+} MapChunk;
+
+// Map memory
+typedef struct{
+	// Directory of chunks, stored row after row
+	// Chunks that only contain the empty value point to a shared chunk
+	MapChunk **chunk;
+
+	// Dimensions in cells
+	int width, height;
+
+	// Dimensions in chunks
+	int chunk_width, chunk_height;
+
+	// Value of cells that were never set
+	MapCell empty;
+
+	// Shared chunk with every cell set to empty
+	MapChunk *shared;
+} MapGrid;
+
+// Returns the chunk holding tile coordinates (x, y) in map memory *g
+#define	MAP_GRID_CHUNK(g, x, y)	((g)->chunk[(size_t) ((y) >> MAP_CHUNK_SHIFT) * (g)->chunk_width + ((x) >> MAP_CHUNK_SHIFT)])
+
+// Returns the index of the cell at tile coordinates (x, y) within its chunk
+#define	MAP_CHUNK_INDEX(x, y)	(((y) & MAP_CHUNK_MASK) << MAP_CHUNK_SHIFT | ((x) & MAP_CHUNK_MASK))
+
+// Returns the cell at tile coordinates (x, y) in map memory *g
+static inline MapCell map_grid_get(const MapGrid *g, int x, int y)
+{
+	return MAP_GRID_CHUNK(g, x, y)->cell[MAP_CHUNK_INDEX(x, y)];
+}
+
+// Returns true if the chunk holding tile coordinates (x, y) in map memory *g is shared, meaning all of its cells are empty
+static inline bool map_grid_chunk_is_shared(const MapGrid *g, int x, int y)
+{
+	return MAP_GRID_CHUNK(g, x, y) == g->shared;
+}
+
+// Sets a cell in a shared chunk of map memory, returns nonzero on error
+// Only map_grid_set() should call this
+int map_grid_set_shared(MapGrid *g, int x, int y, MapCell value);
+
+// Sets the cell at tile coordinates (x, y) in map memory *g, returns nonzero on error
+// The cell's chunk is given its own memory if it was shared
+static inline int map_grid_set(MapGrid *g, int x, int y, MapCell value)
+{
+	MapChunk *c = MAP_GRID_CHUNK(g, x, y);
+	if (c == g->shared)
+		return map_grid_set_shared(g, x, y, value);
+	c->cell[MAP_CHUNK_INDEX(x, y)] = value;
+	return 0;
+}
+
+// Loads a map from a text file, or from a binary map file if path ends in MAP_BIN_EXT (see map_bin.h)
+// The editing parameter is true when the map is being opened for editing
+ErrCode map_load(char *path, bool editing);
+
+// Saves a map to a text file, or to a binary map file if path ends in MAP_BIN_EXT, returns nonzero on error
+int map_save(char *path);
+
 // Loads a map from a text file
 // The editing parameter is true when the map is being opened for editing
 ErrCode map_load_txt(char *path, bool editing);
@@ -87,15 +172,33 @@ ErrCode map_load_txt(char *path, bool editing);
 // Saves a map to a text file, returns nonzero on error
 int map_save_txt(char *path);
 
-// Allocates and returns a pointer to map memory with size bytes for each index, returns NULL on error
-void *map_alloc(int map_width, int map_height, size_t size);
+// Frees the map memory of the last map, allocates map memory for a new map, and resets game systems for the new map
+// Map loaders call this once a map file has been read, returns nonzero on error
+int map_load_begin(const char *path, bool editing, int map_width, int map_height);
+
+// Spawns the entities of a new map from *ent_tile_data
+// Map loaders call this once the tiles and options of a map are set, returns nonzero on error
+// When not editing, *ent_tile_data is given to the collector and replaced with a copy, so the caller only has to free *ent_tile_data
+int map_load_end(MapGrid *ent_tile_data, bool editing);
+
+// Allocates map memory with every cell set to empty, returns nonzero on error
+int map_grid_alloc(MapGrid *g, int map_width, int map_height, MapCell empty);
 
 // Frees map memory
-void map_free(int map_height, void *map_ptr_param);
+void map_grid_free(MapGrid *g);
+
+// Sets every cell of map memory to its empty value
+void map_grid_clear(MapGrid *g);
+
+// Returns the # of bytes used by map memory
+size_t map_grid_mem_size(const MapGrid *g);
+
+// Returns the # of bytes used by the map memory of the current map
+size_t map_mem_size(void);
 
-// Copies map data from *src to *dest
-// For this to work, both *dest and *src must have the same width, height, and size
-void map_copy(int map_width, int map_height, size_t size, void *dest_param, void *src_param);
+// Copies map memory from *src to *dest, returns nonzero on error
+// For this to work, both *dest and *src must have the same width, height, and empty value
+int map_grid_copy(MapGrid *dest, const MapGrid *src);
 
 // Returns false if two entities or tiles share the same map character, should be used in an assert
 bool map_assert_dupchars(void);
@@ -0,0 +1,466 @@
+/*
+ * map_bin.c contains functions for loading and saving maps in the binary map format.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Map binary map files into memory with mmap() where it's available
+#if	(defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+	#define	MAP_BIN_MMAP
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "camera.h"
+#include "dir.h"
+#include "editor/editor.h"	// For g_ent_map
+#include "entity/door.h"
+#include "entity/tile.h"
+#include "error.h"
+#include "init.h"
+#include "map.h"
+#include "map_bin.h"
+#include "tile/data.h"
+#include "tile/plane.h"
+#include "trace.h"
+#include "util/string.h"
+
+// Magic # at the start of every binary map file
+#define	MAP_BIN_MAGIC	"SPMB"
+
+// A binary map file read into memory
+typedef struct{
+	// Contents of the file
+	const uint8_t *data;
+
+	// Size of the file in bytes
+	size_t size;
+
+	// True if data was mapped with mmap(), false if it was read into malloc-obtained memory
+	bool mapped;
+} MapBinFile;
+
+// Reads numbers stored in binary maps
+static inline unsigned int map_bin_get16(const uint8_t *p)
+{
+	return p[0] | p[1] << 8;
+}
+static inline uint32_t map_bin_get32(const uint8_t *p)
+{
+	return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+// Writes numbers stored in binary maps
+static inline void map_bin_put16(uint8_t *p, unsigned int value)
+{
+	p[0] = value & 0xff;
+	p[1] = value >> 8 & 0xff;
+}
+static inline void map_bin_put32(uint8_t *p, uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+		p[i] = value >> (i * 8) & 0xff;
+}
+
+// Reads the file at fullpath into *f, returns nonzero on error
+static int map_bin_open(MapBinFile *f, const char *fullpath)
+{
+#ifdef	MAP_BIN_MMAP
+	int fd = open(fullpath, O_RDONLY);
+	if (fd != -1)
+	{
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED)
+			{
+				close(fd);
+				f->data = data;
+				f->size = st.st_size;
+				f->mapped = true;
+				return 0;
+			}
+		}
+		close(fd);
+	}
+
+	// Fall back to reading the file in
+#endif
+	FILE *file;
+	if ((file = fopen(fullpath, "rb")) == NULL)
+	{
+		PERR("failed to open binary map file \"%s\"", fullpath);
+		return 1;
+	}
+
+	long size;
+	if (fseek(file, 0, SEEK_END) || (size = ftell(file)) <= 0 || fseek(file, 0, SEEK_SET))
+	{
+		PERR("failed to get the size of binary map file \"%s\"", fullpath);
+		fclose(file);
+		return 1;
+	}
+
+	uint8_t *data;
+	if ((data = malloc(size)) == NULL)
+	{
+		PERR("failed to allocate mem for binary map file \"%s\"", fullpath);
+		fclose(file);
+		return 1;
+	}
+	if (fread(data, 1, size, file) != (size_t) size)
+	{
+		PERR("failed to read binary map file \"%s\"", fullpath);
+		free(data);
+		fclose(file);
+		return 1;
+	}
+	fclose(file);
+
+	f->data = data;
+	f->size = size;
+	f->mapped = false;
+	return 0;
+}
+
+// Frees a file read with map_bin_open()
+static void map_bin_close(MapBinFile *f)
+{
+#ifdef	MAP_BIN_MMAP
+	if (f->mapped)
+	{
+		munmap((void *) f->data, f->size);
+		return;
+	}
+#endif
+	free((void *) f->data);
+}
+
+// Returns true if path ends in MAP_BIN_EXT
+bool map_bin_path(const char *path)
+{
+	const size_t len = strlen(path);
+	const size_t ext_len = sizeof(MAP_BIN_EXT) - 1;
+	return len >= ext_len && strcmp(path + len - ext_len, MAP_BIN_EXT) == 0;
+}
+
+// Loads a map from a binary map file
+// The editing parameter is true when the map is being opened for editing
+ErrCode map_load_bin(char *path, bool editing)
+{
+	// Code returned by the function
+	ErrCode err_code = ERR_RECOVER;
+
+	// Contains entities from the entity tiles of the file
+	MapGrid ent_tile_data = {.chunk = NULL};
+
+	// Getting the full path from the path argument
+	char fullpath[RES_PATH_MAX];
+	snprintf(fullpath, RES_PATH_MAX, DIR_MAP "/%s", path);
+	MapBinFile f;
+	if (map_bin_open(&f, fullpath))
+		return err_code;
+
+	// Read the header
+	const uint8_t *header = f.data;
+	if (f.size < MAP_BIN_HEADER_SIZE || memcmp(header, MAP_BIN_MAGIC, 4) != 0)
+	{
+		PERR("\"%s\" is not a binary map file", fullpath);
+		goto l_exit;
+	}
+	if (map_bin_get16(header + 4) != MAP_BIN_VERSION)
+	{
+		PERR("binary map file \"%s\" has version %u, expected " STR(MAP_BIN_VERSION), fullpath, map_bin_get16(header + 4));
+		goto l_exit;
+	}
+	const unsigned int flags = map_bin_get16(header + 6);
+	const int map_width = map_bin_get16(header + 8);
+	const int map_height = map_bin_get16(header + 10);
+	const char ot_char = header[12];
+	const int door_len = header[13];
+	const int vr_len = header[14];
+	const uint32_t ent_len = map_bin_get32(header + 16);
+	if (map_width < 1 || map_width > MAP_WIDTH_MAX || map_height < 1 || map_height > MAP_HEIGHT_MAX)
+	{
+		PERR("binary map file \"%s\" has invalid dimensions %dx%d", fullpath, map_width, map_height);
+		goto l_exit;
+	}
+	if (ent_len > (uint32_t) map_width * map_height || vr_len > VOID_RECT_LIST_LEN || door_len > ENT_DOOR_MAX)
+	{
+		PERR("binary map file \"%s\" has too many entity tiles, void rectangles, or door links", fullpath);
+		goto l_exit;
+	}
+
+	// Find each part of the file
+	const uint8_t *tiles = header + MAP_BIN_HEADER_SIZE;
+	const uint8_t *ents = tiles + (size_t) map_width * map_height;
+	const uint8_t *vrs = ents + (size_t) ent_len * MAP_BIN_ENT_SIZE;
+	const uint8_t *doors = vrs + (size_t) vr_len * MAP_BIN_VR_SIZE;
+	if ((size_t) (doors - f.data) + (size_t) door_len * MAP_BIN_DOOR_SIZE != f.size)
+	{
+		PERR("binary map file \"%s\" has the wrong size", fullpath);
+		goto l_exit;
+	}
+
+	// The file is valid by this point
+
+	// If an error occurs after this point, it is non-recoverable
+	err_code = ERR_NO_RECOVER;
+
+	if (map_load_begin(path, editing, map_width, map_height))
+		goto l_exit;
+	if (map_grid_alloc(&ent_tile_data, map_width, map_height, ENT_TILE_NONE))
+		goto l_exit;
+
+	// Place tiles
+	// Tile memory starts out as air, so only other tiles are set
+	int bad_len = 0;
+	for (int y = 0; y < map_height; ++y)
+	{
+		const uint8_t *row = tiles + (size_t) y * map_width;
+		for (int x = 0; x < map_width; ++x)
+		{
+			const int ti = map_get_tile_id(row[x]);
+			if (ti == -1)
+				++bad_len;
+			else if (map_grid_set(&g_tile_map, x, y, ti))
+				goto l_exit;
+		}
+	}
+	if (bad_len != 0)
+	{
+		PERR("%d tiles with unknown map chars found in \"%s\"", bad_len, fullpath);
+	}
+	if (tile_plane_build())
+		goto l_exit;
+
+	// Place entity tiles
+	bad_len = 0;
+	for (uint32_t i = 0; i < ent_len; ++i)
+	{
+		const uint8_t *e = ents + (size_t) i * MAP_BIN_ENT_SIZE;
+		const int x = map_bin_get16(e);
+		const int y = map_bin_get16(e + 2);
+		const int ei = map_get_ent_id(e[4]);
+		if (x >= map_width || y >= map_height || ei == -1)
+			++bad_len;
+		else if (map_grid_set(&ent_tile_data, x, y, ei))
+			goto l_exit;
+	}
+	if (bad_len != 0)
+	{
+		PERR("%d invalid entity tiles found in \"%s\"", bad_len, fullpath);
+	}
+
+	// Options
+	if (flags & MAP_BIN_FLAG_OT)
+	{
+		const int ti = map_get_tile_id(ot_char);
+		g_tile_outside = ti == -1 ? MAP_DEF_OT : ti;
+	}
+	if (flags & MAP_BIN_FLAG_SS)
+	{
+		g_cam.scroll_stop = true;
+		cam_update_limits();
+	}
+
+	// Void rectangles
+	for (int i = 0; i < vr_len; ++i)
+	{
+		const uint8_t *v = vrs + (size_t) i * MAP_BIN_VR_SIZE;
+		VoidRect *r = &g_map.vr_list.r[g_map.vr_list.len];
+		r->rect.x = map_bin_get16(v);
+		r->rect.y = map_bin_get16(v + 2);
+		r->rect.w = map_bin_get16(v + 4);
+		r->rect.h = map_bin_get16(v + 6);
+		if (r->rect.x + r->rect.w > map_width || r->rect.y + r->rect.h > map_height)
+		{
+			PERR("void rectangle dimensions are out of bounds. skipping rectangle.");
+			continue;
+		}
+		if (v[8] == 'i')
+		{
+			r->value.i = (VoidRectInt) v[9];
+			r->value_is_str = false;
+		}
+		else
+		{
+			memcpy(r->value.s, v + 9, VOID_RECT_STR_LEN);
+			r->value.s[VOID_RECT_STR_LEN - 1] = '\0';
+			r->value_is_str = true;
+		}
+		++g_map.vr_list.len;
+	}
+
+	// Door links
+	for (int i = 0; i < door_len; ++i)
+	{
+		const uint8_t *d = doors + (size_t) i * MAP_BIN_DOOR_SIZE;
+		if (!ENT_DOOR_ID_IS_VALID(d[0]))
+		{
+			PERR("invalid door id %d found in \"%s\"", d[0], fullpath);
+			continue;
+		}
+		memcpy(g_ent_door_map_path[d[0]], d + 1, ENT_DOOR_MAP_PATH_MAX);
+		g_ent_door_map_path[d[0]][ENT_DOOR_MAP_PATH_MAX - 1] = '\0';
+	}
+
+	// Spawn entities
+	if (map_load_end(&ent_tile_data, editing))
+		goto l_exit;
+
+	// Map loaded successfully
+	err_code = ERR_NONE;
+
+l_exit:
+	map_grid_free(&ent_tile_data);
+	map_bin_close(&f);
+	return err_code;
+}
+
+// Saves the current map to a binary map file, returns nonzero on error
+// Entity tiles are taken from g_ent_map, so the map must have been loaded for editing
+int map_save_bin(char *path)
+{
+	if (g_ent_map.chunk == NULL)
+	{
+		PERR("binary maps can only be saved from maps loaded for editing");
+		return 1;
+	}
+
+	// Count entity tiles and door links
+	uint32_t ent_len = 0;
+	for (int y = 0; y < g_map.height; ++y)
+		for (int x = 0; x < g_map.width; ++x)
+			if (map_grid_get(&g_ent_map, x, y) != ENT_TILE_NONE)
+				++ent_len;
+	int door_len = 0;
+	for (int i = 0; i < ENT_DOOR_MAX; ++i)
+		if (g_ent_door_map_path[i][0] != '\0')
+			++door_len;
+
+	// Getting the full path from the path argument
+	char fullpath[RES_PATH_MAX];
+	snprintf(fullpath, RES_PATH_MAX, DIR_MAP "/%s", path);
+
+	// Open the map file
+	FILE *map_file;
+	if ((map_file = fopen(fullpath, "wb")) == NULL)
+	{
+		PERR("failed to open binary map file \"%s\"", fullpath);
+		return 1;
+	}
+
+	// Set to nonzero if a write fails
+	int err = 0;
+
+	// Header
+	uint8_t header[MAP_BIN_HEADER_SIZE] = {0};
+	memcpy(header, MAP_BIN_MAGIC, 4);
+	map_bin_put16(header + 4, MAP_BIN_VERSION);
+	map_bin_put16(header + 6, MAP_BIN_FLAG_OT | (g_cam.scroll_stop ? MAP_BIN_FLAG_SS : 0));
+	map_bin_put16(header + 8, g_map.width);
+	map_bin_put16(header + 10, g_map.height);
+	header[12] = g_tile_md[g_tile_outside].map_char;
+	header[13] = door_len;
+	header[14] = g_map.vr_list.len;
+	map_bin_put32(header + 16, ent_len);
+	err |= fwrite(header, sizeof(header), 1, map_file) != 1;
+
+	// Tile layer
+	uint8_t row[MAP_WIDTH_MAX];
+	for (int y = 0; y < g_map.height; ++y)
+	{
+		for (int x = 0; x < g_map.width; ++x)
+			row[x] = g_tile_md[map_grid_get(&g_tile_map, x, y)].map_char;
+		err |= fwrite(row, g_map.width, 1, map_file) != 1;
+	}
+
+	// Entity tiles
+	for (int y = 0; y < g_map.height; ++y)
+	{
+		for (int x = 0; x < g_map.width; ++x)
+		{
+			const EntTileId ei = map_grid_get(&g_ent_map, x, y);
+			if (ei == ENT_TILE_NONE)
+				continue;
+			uint8_t e[MAP_BIN_ENT_SIZE];
+			map_bin_put16(e, x);
+			map_bin_put16(e + 2, y);
+			e[4] = g_ent_tile[ei].map_char;
+			err |= fwrite(e, sizeof(e), 1, map_file) != 1;
+		}
+	}
+
+	// Void rectangles
+	for (int i = 0; i < g_map.vr_list.len; ++i)
+	{
+		const VoidRect *r = &g_map.vr_list.r[i];
+		uint8_t v[MAP_BIN_VR_SIZE] = {0};
+		map_bin_put16(v, r->rect.x);
+		map_bin_put16(v + 2, r->rect.y);
+		map_bin_put16(v + 4, r->rect.w);
+		map_bin_put16(v + 6, r->rect.h);
+		if (r->value_is_str)
+		{
+			v[8] = 's';
+			memcpy(v + 9, r->value.s, strnlen(r->value.s, VOID_RECT_STR_LEN));
+		}
+		else
+		{
+			v[8] = 'i';
+			v[9] = (uint8_t) r->value.i;
+		}
+		err |= fwrite(v, sizeof(v), 1, map_file) != 1;
+	}
+
+	// Door links
+	for (int i = 0; i < ENT_DOOR_MAX; ++i)
+	{
+		if (g_ent_door_map_path[i][0] == '\0')
+			continue;
+		uint8_t d[MAP_BIN_DOOR_SIZE] = {0};
+		d[0] = i;
+		memcpy(d + 1, g_ent_door_map_path[i], strnlen(g_ent_door_map_path[i], ENT_DOOR_MAP_PATH_MAX));
+		err |= fwrite(d, sizeof(d), 1, map_file) != 1;
+	}
+
+	err |= fclose(map_file) != 0;
+	if (err)
+	{
+		PERR("failed to write binary map file \"%s\"", fullpath);
+	}
+	return err;
+}
+
+// Converts a map between the text and binary formats using the command line arguments that follow "--map2bin" or "--bin2map"
+// to_bin is true when converting text maps to binary maps
+// Returns nonzero on error
+int map_bin_convert_main(int argc, char **argv, bool to_bin)
+{
+	if (argc != 2 || map_bin_path(argv[0]) == to_bin || map_bin_path(argv[1]) != to_bin)
+	{
+		PERR("usage: %s", to_bin ? "--map2bin <map> <map" MAP_BIN_EXT ">" : "--bin2map <map" MAP_BIN_EXT "> <map>");
+		return 1;
+	}
+
+	if (game_init_headless())
+		return 1;
+
+	// Load the map for editing so that every entity tile is kept in g_ent_map
+	int err = 0;
+	if (TRACE_INT("map_load", map_load(argv[0], true)) || map_save(argv[1]))
+		err = 1;
+	else
+		PINF("converted \"%s\" to \"%s\"", argv[0], argv[1]);
+
+	game_quit_headless();
+	return err;
+}
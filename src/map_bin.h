@@ -0,0 +1,72 @@
+/*
+ * map_bin.h contains functions for loading and saving maps in the binary map format.
+ *
+ * Binary maps hold the same data as text maps (see map.h), but they can be loaded without parsing any text. They are stored in the ../res/map directory and end in .mapb. The file is mapped into memory with mmap() where it's available, and read in with one fread() everywhere else.
+ *
+ * All numbers are unsigned and little endian. A binary map file is made of the following parts, one after another:
+ * 	header (MAP_BIN_HEADER_SIZE bytes)
+ * 		magic # "SPMB" (4 bytes)
+ * 		version (2 bytes), MAP_BIN_VERSION
+ * 		flags (2 bytes), any of the MAP_BIN_FLAG_* values
+ * 		width and height of the map in tiles (2 bytes each)
+ * 		map char of the outside tile (1 byte)
+ * 		# of door links (1 byte)
+ * 		# of void rectangles (1 byte)
+ * 		reserved, always 0 (1 byte)
+ * 		# of entity tiles (4 bytes)
+ * 	tile layer: the map char of each tile, row after row (width * height bytes)
+ * 	entity tiles (MAP_BIN_ENT_SIZE bytes each): x and y in tiles (2 bytes each), then the map char of the entity tile (1 byte)
+ * 	void rectangles (MAP_BIN_VR_SIZE bytes each): x, y, w, and h in tiles (2 bytes each), then 'i' or 's' for the type of value (1 byte), then the value (VOID_RECT_STR_LEN bytes). Integer values are stored in the first byte. String values are padded with '\0'.
+ * 	door links (MAP_BIN_DOOR_SIZE bytes each): door id (1 byte), then the map path (ENT_DOOR_MAP_PATH_MAX bytes, padded with '\0')
+ *
+ * Tiles and entity tiles are stored as map chars rather than ids, so binary maps don't break when tiles or entity tiles are added.
+ *
+ * Text maps can be converted to binary maps and back from the command line:
+ * 	soupdl --map2bin turretland.map turretland.mapb
+ * 	soupdl --bin2map turretland.mapb turretland.map
+ */
+
+#ifndef	MAP_BIN_H
+#define	MAP_BIN_H
+
+#include <stdbool.h>
+
+#include "entity/door.h"	// For ENT_DOOR_MAP_PATH_MAX
+#include "error.h"
+#include "void_rect.h"	// For VOID_RECT_STR_LEN
+
+// File extension of binary maps
+#define	MAP_BIN_EXT	".mapb"
+
+// Version of the binary map format written by map_save_bin(), files with other versions can't be loaded
+#define	MAP_BIN_VERSION	1
+
+// Sizes of the parts of a binary map in bytes
+#define	MAP_BIN_HEADER_SIZE	20
+#define	MAP_BIN_ENT_SIZE	5
+#define	MAP_BIN_VR_SIZE		(9 + VOID_RECT_STR_LEN)
+#define	MAP_BIN_DOOR_SIZE	(1 + ENT_DOOR_MAP_PATH_MAX)
+
+// The outside tile is set by the map (like the ot option of text maps)
+#define	MAP_BIN_FLAG_OT		0x1
+
+// Camera scroll stop is enabled by the map (like the ss option of text maps)
+#define	MAP_BIN_FLAG_SS		0x2
+
+// Returns true if path ends in MAP_BIN_EXT
+bool map_bin_path(const char *path);
+
+// Loads a map from a binary map file
+// The editing parameter is true when the map is being opened for editing
+ErrCode map_load_bin(char *path, bool editing);
+
+// Saves the current map to a binary map file, returns nonzero on error
+// Entity tiles are taken from g_ent_map, so the map must have been loaded for editing
+int map_save_bin(char *path);
+
+// Converts a map between the text and binary formats using the command line arguments that follow "--map2bin" or "--bin2map"
+// to_bin is true when converting text maps to binary maps
+// Returns nonzero on error
+int map_bin_convert_main(int argc, char **argv, bool to_bin);
+
+#endif
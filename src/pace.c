@@ -0,0 +1,138 @@
+/*
+ * pace.c contains functions for pacing frames when vsync is disabled and for measuring how long frames take.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <SDL2/SDL.h>
+
+#include "error.h"
+#include "pace.h"
+#include "video.h"
+
+// Performance counter value of the end of the last frame
+static uint64_t g_pace_counter_last = 0;
+
+// Performance counter value that the current frame should end at
+static uint64_t g_pace_deadline = 0;
+
+// # of frames in each histogram bucket
+static unsigned int g_pace_hist[PACE_HIST_LEN];
+
+// Frame time statistics in performance counter ticks
+static unsigned int g_pace_frames = 0;
+static uint64_t g_pace_total = 0;
+static uint64_t g_pace_min = UINT64_MAX;
+static uint64_t g_pace_max = 0;
+
+// Waits until g_pace_deadline
+static void pace_wait(void);
+
+// Returns the frame time that frac of all frames are at or below in milliseconds, from the histogram
+static double pace_percentile(double frac);
+
+// Starts a new frame schedule from now, so time spent before this call (like loading) isn't counted as a frame
+void pace_reset(void)
+{
+	g_pace_counter_last = SDL_GetPerformanceCounter();
+	g_pace_deadline = g_pace_counter_last;
+}
+
+// Ends a frame, waiting until its deadline if vsync is disabled, and records the frame's time
+void pace_frame_end(void)
+{
+#ifndef	__EMSCRIPTEN__
+	// Not needed on emscripten because we control the framerate when calling emscripten_set_main_loop_arg()
+	if (!g_vsync)
+		pace_wait();
+#endif
+
+	const uint64_t counter = SDL_GetPerformanceCounter();
+	const uint64_t frame = counter - g_pace_counter_last;
+	g_pace_counter_last = counter;
+
+	g_pace_frames++;
+	g_pace_total += frame;
+	if (frame < g_pace_min)
+		g_pace_min = frame;
+	if (frame > g_pace_max)
+		g_pace_max = frame;
+
+	uint64_t bucket = frame * 1000000 / SDL_GetPerformanceFrequency() / PACE_HIST_BUCKET_US;
+	if (bucket >= PACE_HIST_LEN)
+		bucket = PACE_HIST_LEN - 1;
+	g_pace_hist[bucket]++;
+}
+
+// Prints frame time statistics and the frame time histogram
+void pace_report(void)
+{
+	if (g_pace_frames == 0)
+		return;
+
+	const double ms_per_tick = 1000.0 / SDL_GetPerformanceFrequency();
+	PINF("frame times over %u frames (ms): min %.3f, avg %.3f, max %.3f, 50%% %.1f, 99%% %.1f",
+		g_pace_frames,
+		g_pace_min * ms_per_tick,
+		(double) g_pace_total / g_pace_frames * ms_per_tick,
+		g_pace_max * ms_per_tick,
+		pace_percentile(0.50),
+		pace_percentile(0.99)
+	);
+	for (int i = 0; i < PACE_HIST_LEN; i++)
+	{
+		if (g_pace_hist[i] == 0)
+			continue;
+		const double ms = i * PACE_HIST_BUCKET_US / 1000.0;
+		const double percent = 100.0 * g_pace_hist[i] / g_pace_frames;
+		if (i == PACE_HIST_LEN - 1)
+		{
+			PINF("  %5.1f+      ms: %6u (%5.1f%%)", ms, g_pace_hist[i], percent);
+		}
+		else
+		{
+			PINF("  %5.1f-%5.1f ms: %6u (%5.1f%%)", ms, ms + PACE_HIST_BUCKET_US / 1000.0, g_pace_hist[i], percent);
+		}
+	}
+}
+
+// Waits until g_pace_deadline
+static void pace_wait(void)
+{
+	const uint64_t freq = SDL_GetPerformanceFrequency();
+	const uint64_t period = freq / g_no_vsync_refresh_rate;
+	const uint64_t spin = freq * PACE_SPIN_MS / 1000;
+	uint64_t counter = SDL_GetPerformanceCounter();
+
+	g_pace_deadline += period;
+
+	// If the frame ran past its deadline by over a full frame, start a new schedule instead of rushing through frames to catch up
+	if (counter > g_pace_deadline + period)
+	{
+		g_pace_deadline = counter;
+		return;
+	}
+
+	// Sleep for most of the wait
+	if (g_pace_deadline > counter + spin)
+		SDL_Delay((g_pace_deadline - counter - spin) * 1000 / freq);
+
+	// Spin for the rest of it
+	while (SDL_GetPerformanceCounter() < g_pace_deadline)
+		;
+}
+
+// Returns the frame time that frac of all frames are at or below in milliseconds, from the histogram
+static double pace_percentile(double frac)
+{
+	const unsigned int target = frac * g_pace_frames;
+	unsigned int frames = 0;
+	for (int i = 0; i < PACE_HIST_LEN; i++)
+	{
+		frames += g_pace_hist[i];
+		if (frames > target)
+			return (i + 1) * PACE_HIST_BUCKET_US / 1000.0;
+	}
+	return PACE_HIST_LEN * PACE_HIST_BUCKET_US / 1000.0;
+}
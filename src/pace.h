@@ -0,0 +1,30 @@
+/*
+ * pace.h contains functions for pacing frames when vsync is disabled and for measuring how long frames take.
+ *
+ * When vsync is disabled, frames are capped to g_no_vsync_refresh_rate by waiting until each frame's deadline. Most of the wait is spent sleeping with SDL_Delay(), which can oversleep by a millisecond or more, so the last PACE_SPIN_MS of it is spent spinning on the performance counter instead. Deadlines are kept on a fixed schedule instead of being measured from the end of the last frame, so small errors don't add up over time.
+ *
+ * The time of every frame is stored in a histogram, which is printed when the game exits.
+ */
+
+#ifndef	PACE_H
+#define	PACE_H
+
+// # of milliseconds before a frame's deadline when sleeping stops and spinning starts
+#define	PACE_SPIN_MS	2
+
+// Width of each histogram bucket in microseconds
+#define	PACE_HIST_BUCKET_US	500
+
+// # of histogram buckets, the last one holds all frames too long to fit in the others
+#define	PACE_HIST_LEN	100
+
+// Starts a new frame schedule from now, so time spent before this call (like loading) isn't counted as a frame
+void pace_reset(void);
+
+// Ends a frame, waiting until its deadline if vsync is disabled, and records the frame's time
+void pace_frame_end(void);
+
+// Prints frame time statistics and the frame time histogram
+void pace_report(void);
+
+#endif
@@ -0,0 +1,347 @@
+/*
+ * particle.c contains the particle system.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <SDL2/SDL.h>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
+#include "camera.h"
+#include "error.h"
+#include "particle.h"
+#include "random.h"
+#include "texture.h"
+#include "timestep.h"
+#include "util/array.h"	// For ARR_LEN()
+#include "video.h"
+
+// Sprite clips for different particle types
+static const SDL_Rect g_ptcl_clip[PTCL_MAX] = {
+	// PTCL_BUBBLE
+	{0, 0, 10, 10},
+	// PTCL_FLAME
+	{10, 0, 10, 10},
+	// PTCL_STAR
+	{20, 0, 10, 10},
+	// PTCL_SAVE
+	{0, 10, 30, 20},
+};
+
+// Position
+static float *g_ptcl_x = NULL;
+static float *g_ptcl_y = NULL;
+
+// Horizontal and vertical speed
+static float *g_ptcl_hsp = NULL;
+static float *g_ptcl_vsp = NULL;
+
+// Gravity
+static float *g_ptcl_grv = NULL;
+
+// Duration in ticks
+static float *g_ptcl_dur = NULL;
+
+// Id of particle (PtclId)
+static Uint8 *g_ptcl_id = NULL;
+
+// # of particles and # of particles the arrays have room for
+static int g_ptcl_len = 0;
+static int g_ptcl_len_max = 0;
+
+// Vertices and indices used to draw particles, 4 vertices and 6 indices per particle
+static SDL_Vertex *g_ptcl_vert = NULL;
+static int *g_ptcl_index = NULL;
+
+// # of particles the vertex and index arrays have room for
+static int g_ptcl_draw_len_max = 0;
+
+// Doubles the size of the particle arrays, returns nonzero on error
+static int ptcl_grow(void);
+
+// Makes the vertex and index arrays big enough to draw len particles, returns nonzero on error
+static int ptcl_draw_grow(int len);
+
+// Moves all particles by one simulation tick and counts down their durations
+static void ptcl_integrate(float ts);
+
+// Removes particles whose durations have run out
+static void ptcl_clean(void);
+
+// Spawns a particle
+void ptcl_new(float x, float y, PtclId id)
+{
+	int dur = 360 + spdl_random();
+	float hsp;
+	float vsp;
+	float grv;
+
+	// Initialize gravity & speeds for the particle's specific type
+	switch (id)
+	{
+	case PTCL_BUBBLE:
+	case PTCL_SAVE:
+		grv = 0.04;
+		hsp = (spdl_random() - 128) / (255.0f) * 2;
+		vsp = -spdl_random() / (255.0f) * 2;
+		break;
+	case PTCL_FLAME:
+		grv = 0;
+		dur = (dur - 360) / 2;
+		hsp = (spdl_random() - 128) / (255.0f) * 1.6f;
+		vsp = (spdl_random() - 128) / (255.0f) * 1.6f;
+		break;
+	case PTCL_STAR:
+		grv = 0.01;
+		hsp = (spdl_random() - 128) / (255.0f);
+		vsp = -spdl_random() / (255.0f);
+		break;
+	default:
+		PERR("unknown particle type (id %d) tried to spawn", (int) id);
+		return;
+	}
+
+	if (g_ptcl_len == g_ptcl_len_max && ptcl_grow())
+		return;
+
+	const int i = g_ptcl_len++;
+	g_ptcl_x[i] = x;
+	g_ptcl_y[i] = y;
+	g_ptcl_hsp[i] = hsp;
+	g_ptcl_vsp[i] = vsp;
+	g_ptcl_grv[i] = grv;
+	g_ptcl_dur[i] = dur;
+	g_ptcl_id[i] = id;
+}
+
+// Updates all particles by one simulation tick and removes the ones that expired
+void ptcl_update_all(void)
+{
+	ptcl_integrate(g_ts);
+	ptcl_clean();
+}
+
+// Draws all particles
+void ptcl_draw_all(void)
+{
+	if (g_ptcl_len == 0 || ptcl_draw_grow(g_ptcl_len))
+		return;
+
+	// Find the texture coordinates of each clip
+	int tex_w;
+	int tex_h;
+	if (SDL_QueryTexture(tex_particle, NULL, NULL, &tex_w, &tex_h) != 0)
+	{
+		PERR("failed to query particle texture. SDL Error: %s", SDL_GetError());
+		return;
+	}
+	SDL_FRect uv[PTCL_MAX];
+	for (int i = 0; i < PTCL_MAX; i++)
+	{
+		uv[i].x = (float) g_ptcl_clip[i].x / tex_w;
+		uv[i].y = (float) g_ptcl_clip[i].y / tex_h;
+		uv[i].w = (float) (g_ptcl_clip[i].x + g_ptcl_clip[i].w) / tex_w;
+		uv[i].h = (float) (g_ptcl_clip[i].y + g_ptcl_clip[i].h) / tex_h;
+	}
+
+	// Particles are snapped to whole pixels like they would be when drawn with SDL_RenderCopy()
+	const SDL_Color color = {255, 255, 255, 255};
+	SDL_Vertex *v = g_ptcl_vert;
+	for (int i = 0; i < g_ptcl_len; i++, v += 4)
+	{
+		const int id = g_ptcl_id[i];
+		const float x1 = (int) (TS_LERP_SPD(g_ptcl_x[i], g_ptcl_hsp[i]) + g_cam.xshift);
+		const float y1 = (int) (TS_LERP_SPD(g_ptcl_y[i], g_ptcl_vsp[i]) + g_cam.yshift);
+		const float x2 = x1 + g_ptcl_clip[id].w;
+		const float y2 = y1 + g_ptcl_clip[id].h;
+		v[0] = (SDL_Vertex) {{x1, y1}, color, {uv[id].x, uv[id].y}};
+		v[1] = (SDL_Vertex) {{x2, y1}, color, {uv[id].w, uv[id].y}};
+		v[2] = (SDL_Vertex) {{x2, y2}, color, {uv[id].w, uv[id].h}};
+		v[3] = (SDL_Vertex) {{x1, y2}, color, {uv[id].x, uv[id].h}};
+	}
+	if (SDL_RenderGeometry(g_renderer, tex_particle, g_ptcl_vert, g_ptcl_len * 4, g_ptcl_index, g_ptcl_len * 6) != 0)
+		PERR("failed to draw particles. SDL Error: %s", SDL_GetError());
+}
+
+// Removes all particles
+void ptcl_reset(void)
+{
+	g_ptcl_len = 0;
+}
+
+// Frees all memory used by particles
+void ptcl_free(void)
+{
+	SDL_SIMDFree(g_ptcl_x);
+	SDL_SIMDFree(g_ptcl_y);
+	SDL_SIMDFree(g_ptcl_hsp);
+	SDL_SIMDFree(g_ptcl_vsp);
+	SDL_SIMDFree(g_ptcl_grv);
+	SDL_SIMDFree(g_ptcl_dur);
+	SDL_SIMDFree(g_ptcl_id);
+	g_ptcl_x = g_ptcl_y = g_ptcl_hsp = g_ptcl_vsp = g_ptcl_grv = g_ptcl_dur = NULL;
+	g_ptcl_id = NULL;
+	g_ptcl_len = g_ptcl_len_max = 0;
+
+	free(g_ptcl_vert);
+	free(g_ptcl_index);
+	g_ptcl_vert = NULL;
+	g_ptcl_index = NULL;
+	g_ptcl_draw_len_max = 0;
+}
+
+// Returns the # of particles
+int ptcl_count(void)
+{
+	return g_ptcl_len;
+}
+
+// Returns the # of bytes allocated for particles
+size_t ptcl_mem_size(void)
+{
+	return (size_t) g_ptcl_len_max * (6 * sizeof(float) + sizeof(Uint8)) +
+		(size_t) g_ptcl_draw_len_max * (4 * sizeof(SDL_Vertex) + 6 * sizeof(int));
+}
+
+// Doubles the size of the particle arrays, returns nonzero on error
+static int ptcl_grow(void)
+{
+	const int len_max = g_ptcl_len_max == 0 ? PTCL_LEN_MIN : g_ptcl_len_max * 2;
+
+	// Arrays that have already been grown are left bigger than needed if a later one fails, which is harmless
+	float **const arr[] = {&g_ptcl_x, &g_ptcl_y, &g_ptcl_hsp, &g_ptcl_vsp, &g_ptcl_grv, &g_ptcl_dur};
+	for (size_t i = 0; i < ARR_LEN(arr); i++)
+	{
+		float *p = SDL_SIMDRealloc(*arr[i], len_max * sizeof(float));
+		if (p == NULL)
+		{
+			PERR("failed to allocate mem for particles");
+			return 1;
+		}
+		*arr[i] = p;
+	}
+	Uint8 *id = SDL_SIMDRealloc(g_ptcl_id, len_max * sizeof(Uint8));
+	if (id == NULL)
+	{
+		PERR("failed to allocate mem for particles");
+		return 1;
+	}
+	g_ptcl_id = id;
+	g_ptcl_len_max = len_max;
+	return 0;
+}
+
+// Makes the vertex and index arrays big enough to draw len particles, returns nonzero on error
+static int ptcl_draw_grow(int len)
+{
+	if (len <= g_ptcl_draw_len_max)
+		return 0;
+
+	// Grow to the size of the particle arrays so this rarely happens
+	const int len_max = g_ptcl_len_max;
+	SDL_Vertex *vert = realloc(g_ptcl_vert, len_max * 4 * sizeof(SDL_Vertex));
+	if (vert == NULL)
+	{
+		PERR("failed to allocate mem for particle vertices");
+		return 1;
+	}
+	g_ptcl_vert = vert;
+	int *index = realloc(g_ptcl_index, len_max * 6 * sizeof(int));
+	if (index == NULL)
+	{
+		PERR("failed to allocate mem for particle indices");
+		return 1;
+	}
+	g_ptcl_index = index;
+
+	// Each particle is a quad made of 2 triangles, and the indices never change, so only the new ones are filled in
+	for (int i = g_ptcl_draw_len_max; i < len_max; i++)
+	{
+		int *quad = g_ptcl_index + i * 6;
+		quad[0] = i * 4;
+		quad[1] = i * 4 + 1;
+		quad[2] = i * 4 + 2;
+		quad[3] = i * 4;
+		quad[4] = i * 4 + 2;
+		quad[5] = i * 4 + 3;
+	}
+	g_ptcl_draw_len_max = len_max;
+	return 0;
+}
+
+// Moves all particles by one simulation tick and counts down their durations
+static void ptcl_integrate(float ts)
+{
+	float *const restrict x = g_ptcl_x;
+	float *const restrict y = g_ptcl_y;
+	float *const restrict hsp = g_ptcl_hsp;
+	float *const restrict vsp = g_ptcl_vsp;
+	float *const restrict grv = g_ptcl_grv;
+	float *const restrict dur = g_ptcl_dur;
+	const int len = g_ptcl_len;
+	int i = 0;
+
+	// The arrays are aligned, but unaligned loads are just as fast on aligned data and don't depend on the alignment SDL picks at runtime
+#if defined(__AVX__)
+	const __m256 ts8 = _mm256_set1_ps(ts);
+	for (; i + 8 <= len; i += 8)
+	{
+		const __m256 v = _mm256_add_ps(_mm256_loadu_ps(vsp + i), _mm256_mul_ps(_mm256_loadu_ps(grv + i), ts8));
+		_mm256_storeu_ps(vsp + i, v);
+		_mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(hsp + i), ts8)));
+		_mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(v, ts8)));
+		_mm256_storeu_ps(dur + i, _mm256_sub_ps(_mm256_loadu_ps(dur + i), ts8));
+	}
+#elif defined(__SSE2__)
+	const __m128 ts4 = _mm_set1_ps(ts);
+	for (; i + 4 <= len; i += 4)
+	{
+		const __m128 v = _mm_add_ps(_mm_loadu_ps(vsp + i), _mm_mul_ps(_mm_loadu_ps(grv + i), ts4));
+		_mm_storeu_ps(vsp + i, v);
+		_mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(hsp + i), ts4)));
+		_mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(v, ts4)));
+		_mm_storeu_ps(dur + i, _mm_sub_ps(_mm_loadu_ps(dur + i), ts4));
+	}
+#endif
+
+	// Particles left over from the SIMD loop, or all of them if SIMD isn't available
+	for (; i < len; i++)
+	{
+		vsp[i] += grv[i] * ts;
+		x[i] += hsp[i] * ts;
+		y[i] += vsp[i] * ts;
+		dur[i] -= ts;
+	}
+}
+
+// Removes particles whose durations have run out
+static void ptcl_clean(void)
+{
+	// Nothing has to move until the first expired particle
+	int i = 0;
+	while (i < g_ptcl_len && g_ptcl_dur[i] > 0)
+		i++;
+
+	// Move every particle that's still alive back over the expired ones, keeping them in order
+	int len = i;
+	for (; i < g_ptcl_len; i++)
+	{
+		if (g_ptcl_dur[i] <= 0)
+			continue;
+		g_ptcl_x[len] = g_ptcl_x[i];
+		g_ptcl_y[len] = g_ptcl_y[i];
+		g_ptcl_hsp[len] = g_ptcl_hsp[i];
+		g_ptcl_vsp[len] = g_ptcl_vsp[i];
+		g_ptcl_grv[len] = g_ptcl_grv[i];
+		g_ptcl_dur[len] = g_ptcl_dur[i];
+		g_ptcl_id[len] = g_ptcl_id[i];
+		len++;
+	}
+	g_ptcl_len = len;
+}
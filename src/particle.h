@@ -0,0 +1,47 @@
+/*
+ * particle.h contains the particle system.
+ *
+ * Particles aren't entities. They're kept in separate arrays for each of their values (x, y, hsp, vsp, grv and dur) so they can be updated several at a time with SIMD instructions, and they're all drawn with one call to SDL_RenderGeometry(). Expired particles are removed at the end of every update by moving the particles after them back.
+ */
+
+#ifndef	PARTICLE_H
+#define	PARTICLE_H
+
+#include <stddef.h>
+
+// # of particles the arrays have room for when they're first allocated
+#define	PTCL_LEN_MIN	256
+
+// Particle id type
+typedef enum{
+	PTCL_BUBBLE,
+	PTCL_FLAME,
+	PTCL_STAR,
+	PTCL_SAVE,
+
+	// Total number of different types of particles
+	PTCL_MAX,
+} PtclId;
+
+// Spawns a particle
+void ptcl_new(float x, float y, PtclId id);
+
+// Updates all particles by one simulation tick and removes the ones that expired
+void ptcl_update_all(void);
+
+// Draws all particles
+void ptcl_draw_all(void);
+
+// Removes all particles
+void ptcl_reset(void);
+
+// Frees all memory used by particles
+void ptcl_free(void);
+
+// Returns the # of particles
+int ptcl_count(void);
+
+// Returns the # of bytes allocated for particles
+size_t ptcl_mem_size(void);
+
+#endif
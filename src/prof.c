@@ -0,0 +1,265 @@
+/*
+ * prof.c contains the frame profiler, which measures how long each stage of the game loop takes.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <SDL2/SDL.h>
+
+#include "entity/all.h"	// For g_ent_drawn & g_ent_culled
+#include "entity/c_body.h"
+#include "entity/id.h"
+#include "entity/root.h"
+#include "error.h"
+#include "font.h"
+#include "particle.h"
+#include "prof.h"
+#include "trace.h"
+#include "video.h"
+
+// Position of the overlay on the screen
+#define	PROF_OVERLAY_X	4
+#define	PROF_OVERLAY_Y	64
+
+// Max length of the overlay text
+#define	PROF_OVERLAY_STR_LEN	4096
+
+// Names of stages that aren't entity stages
+static const char *const g_prof_stage_name[PROF_ENT_UPDATE] = {
+	[PROF_FRAME] = "frame",
+	[PROF_EVENTS] = "events",
+	[PROF_PLAYER_UPDATE] = "player update",
+	[PROF_BARRIER] = "barriers",
+	[PROF_PTCL_UPDATE] = "upd particle",
+	[PROF_BODY] = "bodies",
+	[PROF_CLEAN] = "clean",
+	[PROF_TILES] = "tiles",
+	[PROF_TILES_OUTSIDE] = "tiles outside",
+	[PROF_PTCL_DRAW] = "draw particle",
+	[PROF_PLAYER_DRAW] = "player draw",
+	[PROF_HUD] = "hud",
+	[PROF_PRESENT] = "present",
+};
+
+// Names of entity types
+static const char *const g_prof_ent_name[ENT_MAX] = {
+	[ENT_ID_PLAYER] = "player",
+	[ENT_ID_ITEM] = "item",
+	[ENT_ID_FIREBALL] = "fireball",
+	[ENT_ID_RAGDOLL] = "ragdoll",
+	[ENT_ID_GROUNDGUY] = "groundguy",
+	[ENT_ID_CLOUD] = "cloud",
+	[ENT_ID_SLIDEGUY] = "slideguy",
+	[ENT_ID_EVILBALL] = "evilball",
+	[ENT_ID_TURRET] = "turret",
+	[ENT_ID_DOOR] = "door",
+	[ENT_ID_SAVEBIRD] = "savebird",
+	[ENT_ID_BARRIER] = "barrier",
+	[ENT_ID_COOLEGG] = "coolegg",
+};
+
+// Names of all stages, filled in the first time they're needed
+// These are kept around so trace events can point to them
+static char g_prof_name[PROF_STAGE_MAX][32];
+
+// Performance counter values from when each stage was started
+static uint64_t g_prof_start[PROF_STAGE_MAX];
+
+// Performance counter ticks spent in each stage this frame
+static uint64_t g_prof_frame[PROF_STAGE_MAX];
+
+// Performance counter ticks spent in each stage in the last PROF_HISTORY_LEN frames
+static uint64_t g_prof_history[PROF_HISTORY_LEN][PROF_STAGE_MAX];
+
+// Index in g_prof_history that the next frame is stored at
+static int g_prof_history_index = 0;
+
+// # of frames written to the CSV file
+static unsigned int g_prof_csv_frames;
+
+// True if the overlay is shown
+static bool g_prof_show = false;
+
+// CSV file that frame timings are written to, or NULL if it isn't open
+static FILE *g_prof_csv = NULL;
+
+// Returns the name of a stage
+static const char *prof_stage_name(ProfStage stage);
+
+// Converts performance counter ticks to milliseconds
+static double prof_ticks_to_ms(uint64_t ticks);
+
+// Starts timing a stage
+void prof_start(ProfStage stage)
+{
+	g_prof_start[stage] = SDL_GetPerformanceCounter();
+#ifdef	TRACE_ENABLED
+	trace_begin(prof_stage_name(stage));
+#endif
+}
+
+// Stops timing a stage, adding the time since prof_start() was called to the stage's time for this frame
+void prof_stop(ProfStage stage)
+{
+	g_prof_frame[stage] += SDL_GetPerformanceCounter() - g_prof_start[stage];
+#ifdef	TRACE_ENABLED
+	trace_end(prof_stage_name(stage));
+#endif
+}
+
+// Stores the timings of the current frame in the history and writes them to the CSV file if it's open
+void prof_frame_end(void)
+{
+	if (g_prof_csv != NULL)
+	{
+		fprintf(g_prof_csv, "%u", g_prof_csv_frames++);
+		for (int i = 0; i < PROF_STAGE_MAX; i++)
+			fprintf(g_prof_csv, ",%.4f", prof_ticks_to_ms(g_prof_frame[i]));
+		for (int i = 1; i < ENT_MAX; i++)
+			fprintf(g_prof_csv, ",%d", g_er[i]->len);
+		fprintf(g_prof_csv, ",%d", ptcl_count());
+		fprintf(g_prof_csv, ",%d", ecm_body_count());
+		fputc('\n', g_prof_csv);
+	}
+
+	for (int i = 0; i < PROF_STAGE_MAX; i++)
+	{
+		g_prof_history[g_prof_history_index][i] = g_prof_frame[i];
+		g_prof_frame[i] = 0;
+	}
+	if (++g_prof_history_index == PROF_HISTORY_LEN)
+		g_prof_history_index = 0;
+}
+
+// Draws the profiler overlay if it's shown
+void prof_draw(void)
+{
+	if (!g_prof_show)
+		return;
+
+	char str[PROF_OVERLAY_STR_LEN];
+	int len = snprintf(str, PROF_OVERLAY_STR_LEN, "stage           avg ms  max ms    count  culled\n");
+	int lines = 1;
+	for (int i = 0; i < PROF_STAGE_MAX && len < PROF_OVERLAY_STR_LEN; i++)
+	{
+		uint64_t total = 0;
+		uint64_t max = 0;
+		for (int j = 0; j < PROF_HISTORY_LEN; j++)
+		{
+			total += g_prof_history[j][i];
+			if (g_prof_history[j][i] > max)
+				max = g_prof_history[j][i];
+		}
+
+		// Only show stages that have run recently
+		if (max == 0)
+			continue;
+
+		len += snprintf(str + len, PROF_OVERLAY_STR_LEN - len, "%-14s %7.3f %7.3f", prof_stage_name(i), prof_ticks_to_ms(total) / PROF_HISTORY_LEN, prof_ticks_to_ms(max));
+		if ((i == PROF_PTCL_UPDATE || i == PROF_PTCL_DRAW) && len < PROF_OVERLAY_STR_LEN)
+			len += snprintf(str + len, PROF_OVERLAY_STR_LEN - len, " %8d", ptcl_count());
+		else if (i == PROF_BODY && len < PROF_OVERLAY_STR_LEN)
+			len += snprintf(str + len, PROF_OVERLAY_STR_LEN - len, " %8d", ecm_body_count());
+		else if (i >= PROF_ENT_DRAW && len < PROF_OVERLAY_STR_LEN)
+		{
+			EntId id = i - PROF_ENT_DRAW;
+			len += snprintf(str + len, PROF_OVERLAY_STR_LEN - len, " %8d %7d", g_ent_drawn[id], g_ent_culled[id]);
+		}
+		else if (i >= PROF_ENT_UPDATE && len < PROF_OVERLAY_STR_LEN)
+		{
+			EntId id = i - PROF_ENT_UPDATE;
+			if (g_er[id] != NULL)
+				len += snprintf(str + len, PROF_OVERLAY_STR_LEN - len, " %8d", g_er[id]->len);
+		}
+		if (len < PROF_OVERLAY_STR_LEN)
+			str[len++] = '\n';
+		lines++;
+	}
+	if (len >= PROF_OVERLAY_STR_LEN)
+		len = PROF_OVERLAY_STR_LEN - 1;
+	str[len] = '\0';
+
+	// Darken the area behind the text
+	const SDL_Rect bg = {
+		PROF_OVERLAY_X - 2,
+		PROF_OVERLAY_Y - 2,
+		48 * FONT_CHAR_XSPACE + 4,
+		lines * FONT_CHAR_YSPACE + 4,
+	};
+	SDL_SetRenderDrawBlendMode(g_renderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(g_renderer, 0, 0, 0, 160);
+	SDL_RenderFillRect(g_renderer, &bg);
+	SDL_SetRenderDrawBlendMode(g_renderer, SDL_BLENDMODE_NONE);
+
+	font_draw_text(str, PROF_OVERLAY_X, PROF_OVERLAY_Y);
+}
+
+// Shows or hides the profiler overlay
+void prof_toggle_overlay(void)
+{
+	g_prof_show = !g_prof_show;
+}
+
+// Starts or stops writing frame timings to PROF_CSV_PATH
+void prof_toggle_csv(void)
+{
+	if (g_prof_csv != NULL)
+	{
+		prof_quit();
+		return;
+	}
+
+	if ((g_prof_csv = fopen(PROF_CSV_PATH, "w")) == NULL)
+	{
+		PERR("failed to open \"%s\" for writing", PROF_CSV_PATH);
+		return;
+	}
+
+	// Header row
+	fprintf(g_prof_csv, "frame");
+	for (int i = 0; i < PROF_STAGE_MAX; i++)
+		fprintf(g_prof_csv, ",%s ms", prof_stage_name(i));
+	for (int i = 1; i < ENT_MAX; i++)
+		fprintf(g_prof_csv, ",%s count", g_prof_ent_name[i]);
+	fprintf(g_prof_csv, ",particle count");
+	fprintf(g_prof_csv, ",body count");
+	fputc('\n', g_prof_csv);
+
+	g_prof_csv_frames = 0;
+	PINF("writing frame timings to \"%s\"", PROF_CSV_PATH);
+}
+
+// Closes the CSV file if it's open
+void prof_quit(void)
+{
+	if (g_prof_csv == NULL)
+		return;
+	if (fclose(g_prof_csv) != 0)
+		PERR("failed to close \"%s\"", PROF_CSV_PATH);
+	g_prof_csv = NULL;
+	PINF("wrote %u frames of timings to \"%s\"", g_prof_csv_frames, PROF_CSV_PATH);
+}
+
+// Returns the name of a stage
+static const char *prof_stage_name(ProfStage stage)
+{
+	char *name = g_prof_name[stage];
+	if (name[0] != '\0')
+		return name;
+
+	if (stage < PROF_ENT_UPDATE)
+		snprintf(name, sizeof(g_prof_name[0]), "%s", g_prof_stage_name[stage]);
+	else if (stage < PROF_ENT_DRAW)
+		snprintf(name, sizeof(g_prof_name[0]), "upd %s", g_prof_ent_name[stage - PROF_ENT_UPDATE]);
+	else
+		snprintf(name, sizeof(g_prof_name[0]), "draw %s", g_prof_ent_name[stage - PROF_ENT_DRAW]);
+	return name;
+}
+
+// Converts performance counter ticks to milliseconds
+static double prof_ticks_to_ms(uint64_t ticks)
+{
+	return ticks * 1000.0 / SDL_GetPerformanceFrequency();
+}
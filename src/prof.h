@@ -0,0 +1,79 @@
+/*
+ * prof.h contains the frame profiler, which measures how long each stage of the game loop takes.
+ *
+ * Each stage of a frame is wrapped in PROF_START() and PROF_STOP(). When a frame ends, the time spent in every stage is stored in a history of the last PROF_HISTORY_LEN frames. The history is shown in an overlay with the average and max time of each stage, next to the # of entities of each type, the # of particles and the # of bodies in the body store. Entity draw stages show how many entities were drawn and how many were culled for being off screen. The same data can also be written to a CSV file, one row per frame.
+ *
+ * In the game, F3 toggles the overlay and F4 toggles writing to PROF_CSV_PATH.
+ */
+
+#ifndef	PROF_H
+#define	PROF_H
+
+#include "entity/id.h"
+
+// If defined, stage timings are recorded
+#define	PROF_ENABLED
+
+// # of frames that timings are kept for
+#define	PROF_HISTORY_LEN	60
+
+// Path of the CSV file that frame timings are written to
+#define	PROF_CSV_PATH	"prof.csv"
+
+// Stages of a frame that are timed
+typedef enum{
+	// The whole frame
+	PROF_FRAME,
+
+	// Game loop stages
+	PROF_EVENTS,
+	PROF_PLAYER_UPDATE,
+	PROF_BARRIER,
+	PROF_PTCL_UPDATE,
+	PROF_BODY,
+	PROF_CLEAN,
+	PROF_TILES,
+	PROF_TILES_OUTSIDE,
+	PROF_PTCL_DRAW,
+	PROF_PLAYER_DRAW,
+	PROF_HUD,
+	PROF_PRESENT,
+
+	// Updating and drawing entities, indexed by entity id
+	PROF_ENT_UPDATE,
+	PROF_ENT_DRAW = PROF_ENT_UPDATE + ENT_MAX,
+
+	// Number of stages (must be listed last)
+	PROF_STAGE_MAX = PROF_ENT_DRAW + ENT_MAX,
+} ProfStage;
+
+#ifdef	PROF_ENABLED
+	#define	PROF_START(stage)	prof_start(stage)
+	#define	PROF_STOP(stage)	prof_stop(stage)
+#else
+	#define	PROF_START(stage)	do{}while(0)
+	#define	PROF_STOP(stage)	do{}while(0)
+#endif
+
+// Starts timing a stage
+void prof_start(ProfStage stage);
+
+// Stops timing a stage, adding the time since prof_start() was called to the stage's time for this frame
+void prof_stop(ProfStage stage);
+
+// Stores the timings of the current frame in the history and writes them to the CSV file if it's open
+void prof_frame_end(void);
+
+// Draws the profiler overlay if it's shown
+void prof_draw(void);
+
+// Shows or hides the profiler overlay
+void prof_toggle_overlay(void);
+
+// Starts or stops writing frame timings to PROF_CSV_PATH
+void prof_toggle_csv(void);
+
+// Closes the CSV file if it's open
+void prof_quit(void);
+
+#endif
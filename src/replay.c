@@ -0,0 +1,338 @@
+/*
+ * replay.c contains functions for recording the player's input to a file and playing it back.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <SDL2/SDL.h>
+
+#include "entity/all.h"
+#include "error.h"
+#include "input.h"
+#include "map.h"
+#include "particle.h"
+#include "replay.h"
+#include "timestep.h"
+#include "trace.h"
+#include "util/array.h"	// For ARR_LEN()
+#include "video.h"
+
+// Magic bytes at the start of every replay file
+#define	REPLAY_MAGIC	"SPRP"
+
+// Offset of the frame count from the start of a replay file
+#define	REPLAY_FRAMES_OFFSET	(4 + 1 + sizeof(double) + 2 * sizeof(int32_t) + MAP_PATH_MAX)
+
+// Player keys stored in a frame, in the order of their bit flags
+static const SDL_Scancode g_replay_key[] = {
+	P_KEY_UP,
+	P_KEY_DOWN,
+	P_KEY_LEFT,
+	P_KEY_RIGHT,
+	P_KEY_JUMP,
+	P_KEY_SHOOT,
+};
+
+// What the replay system is currently doing
+ReplayState g_replay_state = REPLAY_NONE;
+
+// The replay file being recorded to or played back from
+static FILE *g_replay_file;
+
+// Total # of frames in the replay, and the # of frames recorded or played back so far
+static uint32_t g_replay_frames;
+static uint32_t g_replay_frame;
+
+// The first frame on which a played back replay's game state differed from its recording, or -1 if there was none
+static int64_t g_replay_desync_frame;
+
+// Keyboard state used while playing back a replay
+static uint8_t g_replay_key_state[SDL_NUM_SCANCODES];
+
+// Reads or writes len bytes of data at ptr from or to the replay file
+// Returns nonzero on error
+static int replay_read(void *ptr, size_t len);
+static int replay_write(const void *ptr, size_t len);
+
+// Returns a checksum of the parts of the game state that player input affects
+static uint32_t replay_checksum(void);
+
+// Updates a FNV-1a hash with len bytes of data at ptr
+static uint32_t replay_hash(uint32_t hash, const void *ptr, size_t len);
+
+// Starts recording player input to the file at path, starting from the current map
+// Returns nonzero on error
+int replay_record_start(const char *path)
+{
+	if ((g_replay_file = fopen(path, "wb")) == NULL)
+	{
+		PERR("failed to open replay file \"%s\" for writing", path);
+		return 1;
+	}
+
+	const uint8_t version = REPLAY_VERSION;
+	const int32_t screen_width = g_screen_width;
+	const int32_t screen_height = g_screen_height;
+	g_replay_frames = 0;
+	if (
+		replay_write(REPLAY_MAGIC, 4) ||
+		replay_write(&version, sizeof(version)) ||
+		replay_write(&g_ts, sizeof(g_ts)) ||
+		replay_write(&screen_width, sizeof(screen_width)) ||
+		replay_write(&screen_height, sizeof(screen_height)) ||
+		replay_write(g_map.path, MAP_PATH_MAX) ||
+		replay_write(&g_replay_frames, sizeof(g_replay_frames))
+	)
+	{
+		fclose(g_replay_file);
+		return 1;
+	}
+
+	g_replay_frame = 0;
+	g_replay_state = REPLAY_RECORDING;
+	PINF("recording input to \"%s\"", path);
+	return 0;
+}
+
+// Starts playing back the replay at path, setting the timestep and screen dimensions it was recorded with and loading its map
+// Returns nonzero on error
+int replay_play_start(const char *path)
+{
+	if ((g_replay_file = fopen(path, "rb")) == NULL)
+	{
+		PERR("failed to open replay file \"%s\"", path);
+		return 1;
+	}
+
+	char magic[4];
+	uint8_t version;
+	double ts;
+	int32_t screen_width;
+	int32_t screen_height;
+	char map_path[MAP_PATH_MAX];
+	if (
+		replay_read(magic, 4) ||
+		replay_read(&version, sizeof(version)) ||
+		replay_read(&ts, sizeof(ts)) ||
+		replay_read(&screen_width, sizeof(screen_width)) ||
+		replay_read(&screen_height, sizeof(screen_height)) ||
+		replay_read(map_path, MAP_PATH_MAX) ||
+		replay_read(&g_replay_frames, sizeof(g_replay_frames))
+	)
+		goto l_error;
+	if (memcmp(magic, REPLAY_MAGIC, 4) != 0)
+	{
+		PERR("\"%s\" isn't a replay file", path);
+		goto l_error;
+	}
+	if (version != REPLAY_VERSION)
+	{
+		PERR("replay \"%s\" has version %d, expected version %d", path, version, REPLAY_VERSION);
+		goto l_error;
+	}
+	map_path[MAP_PATH_MAX - 1] = '\0';
+
+	// Recreate the conditions the replay was recorded in
+	g_ts = ts;
+	g_screen_width = screen_width;
+	g_screen_height = screen_height;
+	g_key_state = g_replay_key_state;
+	if (TRACE_INT("map_load", map_load(map_path, false)))
+		goto l_error;
+	ent_cloud_update_count();
+
+	g_replay_frame = 0;
+	g_replay_desync_frame = -1;
+	g_replay_state = REPLAY_PLAYING;
+	return 0;
+l_error:
+	fclose(g_replay_file);
+	return 1;
+}
+
+// Returns true if the replay being played back has frames left to play
+bool replay_frames_left(void)
+{
+	return g_replay_state == REPLAY_PLAYING && g_replay_frame < g_replay_frames;
+}
+
+// Records or plays back the player input for the current frame
+// This should be called at the start of every frame, before player input is handled
+void replay_update(void)
+{
+	uint32_t checksum;
+	uint8_t keys;
+	uint8_t keydowns;
+	int32_t keycode;
+
+	switch (g_replay_state)
+	{
+	case REPLAY_NONE:
+		break;
+	case REPLAY_RECORDING:
+		checksum = replay_checksum();
+		keys = 0;
+		for (size_t i = 0; i < ARR_LEN(g_replay_key); i++)
+			if (g_key_state[g_replay_key[i]])
+				keys |= 1 << i;
+		keydowns = g_keydown_queue.len;
+		if (
+			replay_write(&checksum, sizeof(checksum)) ||
+			replay_write(&keys, sizeof(keys)) ||
+			replay_write(&keydowns, sizeof(keydowns))
+		)
+			goto l_error;
+		for (int i = 0; i < keydowns; i++)
+		{
+			keycode = g_keydown_queue.key[i];
+			if (replay_write(&keycode, sizeof(keycode)))
+				goto l_error;
+		}
+		g_replay_frame++;
+		break;
+	case REPLAY_PLAYING:
+		if (g_replay_frame == g_replay_frames)
+			break;
+		if (
+			replay_read(&checksum, sizeof(checksum)) ||
+			replay_read(&keys, sizeof(keys)) ||
+			replay_read(&keydowns, sizeof(keydowns))
+		)
+			goto l_error;
+		if (g_replay_desync_frame == -1 && checksum != replay_checksum())
+			g_replay_desync_frame = g_replay_frame;
+		for (size_t i = 0; i < ARR_LEN(g_replay_key); i++)
+			g_replay_key_state[g_replay_key[i]] = (keys >> i) & 1;
+		g_keydown_queue.len = 0;
+		for (int i = 0; i < keydowns; i++)
+		{
+			if (replay_read(&keycode, sizeof(keycode)))
+				goto l_error;
+			input_queue_keydown(keycode);
+		}
+		g_replay_frame++;
+		break;
+	}
+	return;
+l_error:
+	PERR("replay stopped on frame %u", (unsigned int) g_replay_frame);
+	if (g_replay_state == REPLAY_RECORDING)
+	{
+		fclose(g_replay_file);
+		g_replay_state = REPLAY_NONE;
+	}
+	else
+	{
+		// End playback early, the replay is reported as desynced when it's stopped
+		g_replay_frames = g_replay_frame;
+		g_replay_desync_frame = g_replay_frame;
+	}
+}
+
+// Stops recording or playing back
+// Returns nonzero if a replay was played back but didn't reach the same game state as its recording
+int replay_stop(void)
+{
+	uint32_t checksum;
+	int desynced = 0;
+
+	switch (g_replay_state)
+	{
+	case REPLAY_NONE:
+		return 0;
+	case REPLAY_RECORDING:
+		// Write the final game state & go back to fill in the frame count
+		checksum = replay_checksum();
+		if (
+			replay_write(&checksum, sizeof(checksum)) ||
+			fseek(g_replay_file, REPLAY_FRAMES_OFFSET, SEEK_SET) != 0 ||
+			replay_write(&g_replay_frame, sizeof(g_replay_frame))
+		)
+		{
+			PERR("failed to finish writing replay");
+		}
+		else
+		{
+			PINF("recorded %u frames of input", (unsigned int) g_replay_frame);
+		}
+		break;
+	case REPLAY_PLAYING:
+		if (g_replay_desync_frame == -1 && g_replay_frame == g_replay_frames)
+		{
+			if (replay_read(&checksum, sizeof(checksum)) == 0 && checksum != replay_checksum())
+				g_replay_desync_frame = g_replay_frames;
+		}
+		if (g_replay_desync_frame != -1)
+		{
+			PERR("replay desynced on frame %ld", (long) g_replay_desync_frame);
+			desynced = 1;
+		}
+		else if (g_replay_frame < g_replay_frames)
+		{
+			PERR("replay stopped after %u of %u frames", (unsigned int) g_replay_frame, (unsigned int) g_replay_frames);
+			desynced = 1;
+		}
+		break;
+	}
+	fclose(g_replay_file);
+	g_replay_state = REPLAY_NONE;
+	return desynced;
+}
+
+// Reads len bytes of data at ptr from the replay file
+// Returns nonzero on error
+static int replay_read(void *ptr, size_t len)
+{
+	if (fread(ptr, len, 1, g_replay_file) != 1)
+	{
+		PERR("failed to read from replay file");
+		return 1;
+	}
+	return 0;
+}
+
+// Writes len bytes of data at ptr to the replay file
+// Returns nonzero on error
+static int replay_write(const void *ptr, size_t len)
+{
+	if (fwrite(ptr, len, 1, g_replay_file) != 1)
+	{
+		PERR("failed to write to replay file");
+		return 1;
+	}
+	return 0;
+}
+
+// Returns a checksum of the parts of the game state that player input affects
+static uint32_t replay_checksum(void)
+{
+	uint32_t hash = 2166136261u;
+	hash = replay_hash(hash, g_map.path, strlen(g_map.path));
+	hash = replay_hash(hash, &g_player.b.x, sizeof(g_player.b.x));
+	hash = replay_hash(hash, &g_player.b.y, sizeof(g_player.b.y));
+	hash = replay_hash(hash, &g_player.b.hsp, sizeof(g_player.b.hsp));
+	hash = replay_hash(hash, &g_player.b.vsp, sizeof(g_player.b.vsp));
+	hash = replay_hash(hash, &g_player.hp, sizeof(g_player.hp));
+	hash = replay_hash(hash, &g_player.coins, sizeof(g_player.coins));
+	hash = replay_hash(hash, &g_player.trumpet_shots, sizeof(g_player.trumpet_shots));
+	for (int i = 1; i < ENT_MAX; i++)
+		hash = replay_hash(hash, &g_er[i]->len, sizeof(g_er[i]->len));
+	const int ptcl_len = ptcl_count();
+	hash = replay_hash(hash, &ptcl_len, sizeof(ptcl_len));
+	return hash;
+}
+
+// Updates a FNV-1a hash with len bytes of data at ptr
+static uint32_t replay_hash(uint32_t hash, const void *ptr, size_t len)
+{
+	const uint8_t *byte = ptr;
+	for (size_t i = 0; i < len; i++)
+	{
+		hash ^= byte[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
@@ -0,0 +1,71 @@
+/*
+ * replay.h contains functions for recording the player's input to a file and playing it back.
+ *
+ * A replay starts on a map and stores the keys held by the player and the keydown events passed to ent_player_keydown() on every frame. Along with the input, every frame stores a checksum of the game state so that a replay that doesn't reach the same state as its recording can be detected on the exact frame it goes wrong. Replays are played back in the same timestep and screen dimensions they were recorded with, since both affect the simulation.
+ *
+ * Changes to the screen dimensions and the map can't be recorded, so while recording, the screen scaling keys (1-4) and the editor key (e) are ignored, and resizing the window stops the recording. The replay file is still valid up to the frame the window was resized on.
+ *
+ * Replay files are binary files in the machine's native byte order with the following layout:
+ * 	header:
+ * 		char[4]			magic bytes "SPRP"
+ * 		uint8_t			version (REPLAY_VERSION)
+ * 		double			timestep
+ * 		int32_t, int32_t	screen width and height
+ * 		char[MAP_PATH_MAX]	path of the map the replay starts on
+ * 		uint32_t		# of frames
+ * 	frames:
+ * 		uint32_t		checksum of the game state at the start of the frame
+ * 		uint8_t			bit flags for the player keys held (see g_replay_key in replay.c)
+ * 		uint8_t			# of keydown events
+ * 		int32_t[]		keycodes of the keydown events
+ * 	trailer:
+ * 		uint32_t		checksum of the game state after the last frame
+ *
+ * Input is recorded with:
+ * 	soupdl --record <file> [map]
+ * and played back as fast as possible without a window with:
+ * 	soupdl --replay <file>
+ */
+
+#ifndef	REPLAY_H
+#define	REPLAY_H
+
+#include <stdbool.h>
+
+// Version of the replay file format
+#define	REPLAY_VERSION	2
+
+typedef enum{
+	// Input isn't being recorded or played back
+	REPLAY_NONE,
+
+	// Input is being recorded
+	REPLAY_RECORDING,
+
+	// Input is being played back
+	REPLAY_PLAYING,
+} ReplayState;
+
+// What the replay system is currently doing
+extern ReplayState g_replay_state;
+
+// Starts recording player input to the file at path, starting from the current map
+// Returns nonzero on error
+int replay_record_start(const char *path);
+
+// Starts playing back the replay at path, setting the timestep and screen dimensions it was recorded with and loading its map
+// Returns nonzero on error
+int replay_play_start(const char *path);
+
+// Returns true if the replay being played back has frames left to play
+bool replay_frames_left(void);
+
+// Records or plays back the player input for the current frame
+// This should be called at the start of every frame, before player input is handled
+void replay_update(void);
+
+// Stops recording or playing back
+// Returns nonzero if a replay was played back but didn't reach the same game state as its recording
+int replay_stop(void);
+
+#endif
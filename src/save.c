@@ -10,8 +10,9 @@
 #include "error.h"
 #include "entity/player.h"	// For g_player
 #include "fileio.h"		// For spdl_getline()
-#include "map.h"		// For map_load_txt() and g_map
+#include "map.h"		// For map_load() and g_map
 #include "save.h"
+#include "trace.h"
 
 #include "entity/tile.h"
 #include "collector.h"
@@ -100,7 +101,7 @@ ErrCode spdl_load(void)
 		.path = NULL,
 		.width = -1,
 		.height = -1,
-		.map = NULL,
+		.map = {.chunk = NULL},
 	};
 
 	// Reset collector
@@ -151,12 +152,8 @@ ErrCode spdl_load(void)
 		}
 
 		// Allocate space for map
-		cmd.map = map_alloc(cmd.width, cmd.height, sizeof(EntTileId));
-		if (cmd.map == NULL)
-		{
-			PERR("failed to allocate mem for cmd.map");
+		if (map_grid_alloc(&cmd.map, cmd.width, cmd.height, ENT_TILE_NONE))
 			goto l_exit;
-		}
 
 		// Read entity tile data
 		for (int y = 0; y < cmd.height; ++y)
@@ -170,10 +167,8 @@ ErrCode spdl_load(void)
 					goto l_exit;
 				}
 				int ei = map_get_ent_id(c);
-				if (ei == -1)
-					cmd.map[y][x] = ENT_TILE_NONE;
-				else
-					cmd.map[y][x] = ei;
+				if (ei != -1 && map_grid_set(&cmd.map, x, y, ei))
+					goto l_exit;
 			}
 
 			// Skip newline
@@ -192,7 +187,7 @@ ErrCode spdl_load(void)
 
 		// Reset pointers in cmd to NULL so they aren't freed
 		cmd.path = NULL;
-		cmd.map = NULL;
+		cmd.map.chunk = NULL;
 	}
 
 	// Close the save file
@@ -204,7 +199,7 @@ ErrCode spdl_load(void)
 
 	// Attempt to load save file map
 	{
-		err_code = map_load_txt(savefile_map, false);
+		err_code = TRACE_INT("map_load", map_load(savefile_map, false));
 		if (err_code != ERR_NONE)
 			goto l_exit;
 	}
@@ -225,7 +220,7 @@ ErrCode spdl_load(void)
 	PINF("load game successful");
 l_exit:
 	free(cmd.path);
-	map_free(cmd.height, cmd.map);
+	map_grid_free(&cmd.map);
 	return err_code;
 }
 
@@ -286,7 +281,7 @@ ErrCode spdl_save(void)
 		{
 			for (int x = 0; x < cmd->width; ++x)
 			{
-				if (fputc(g_ent_tile[cmd->map[y][x]].map_char, savefile) == EOF)
+				if (fputc(g_ent_tile[map_grid_get(&cmd->map, x, y)].map_char, savefile) == EOF)
 				{
 					PERR("failed to write collector data to save file \"%s\"", savefile_path);
 					err_code = ERR_RECOVER;
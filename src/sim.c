@@ -0,0 +1,68 @@
+/*
+ * sim.c contains functions for updating the game world, separate from drawing it.
+ */
+
+#include "barrier.h"
+#include "camera.h"
+#include "entity/all.h"
+#include "entity/c_body.h"
+#include "input.h"
+#include "particle.h"
+#include "prof.h"
+#include "replay.h"
+#include "sim.h"
+
+// Functions for updating entities in jobs
+ENT_UPDATE_RANGE_FUNC(FIREBALL)
+ENT_UPDATE_RANGE_FUNC(EVILBALL)
+ENT_UPDATE_LOD_RANGE_FUNC(TURRET)
+
+// Updates the player, camera, all entities and barriers by one simulation tick, handling the player input queued for it
+void sim_update(void)
+{
+	replay_update();
+	input_handle_keydowns();
+
+	// Store the camera's position for interpolating drawing
+	g_cam.xprev = g_cam.x;
+	g_cam.yprev = g_cam.y;
+
+	PROF_START(PROF_PLAYER_UPDATE);
+	ent_player_update();
+	PROF_STOP(PROF_PLAYER_UPDATE);
+	cam_update_shifts();
+
+	// Entities spawned by other entities are added to their arrays after every entity is updated
+	ent_spawn_begin();
+	ENT_UPDATE_JOBS(FIREBALL);
+	ENT_UPDATE_JOBS(EVILBALL);
+
+	// Fireballs and evilballs have moved
+	ent_grid_dirty(ENT_ID_FIREBALL);
+	ent_grid_dirty(ENT_ID_EVILBALL);
+
+	PROF_START(PROF_PTCL_UPDATE);
+	ptcl_update_all();
+	PROF_STOP(PROF_PTCL_UPDATE);
+
+	// Move every body before the entities that own them react to what they hit
+	PROF_START(PROF_BODY);
+	ecm_body_update_all();
+	PROF_STOP(PROF_BODY);
+	ENT_UPDATE(RAGDOLL);
+	ENT_UPDATE_LOD(GROUNDGUY);
+	ENT_UPDATE(CLOUD);
+	ENT_UPDATE_LOD(SLIDEGUY);
+	ENT_UPDATE_JOBS(TURRET);
+	ENT_UPDATE(COOLEGG);
+	ent_spawn_end();
+
+	PROF_START(PROF_BARRIER);
+	barrier_handle_check_requests();
+	PROF_STOP(PROF_BARRIER);
+
+	// Delete everything destroyed this tick
+	PROF_START(PROF_CLEAN);
+	ent_clean_all();
+	PROF_STOP(PROF_CLEAN);
+}
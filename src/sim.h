@@ -0,0 +1,11 @@
+/*
+ * sim.h contains functions for updating the game world, separate from drawing it.
+ */
+
+#ifndef	SIM_H
+#define	SIM_H
+
+// Updates the player, camera, all entities and barriers by one simulation tick, handling the player input queued for it
+void sim_update(void);
+
+#endif
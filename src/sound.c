@@ -113,12 +113,17 @@ void snd_free_all(void)
 // Play a sound effect
 void snd_play(Mix_Chunk *snd)
 {
+	// Sounds aren't loaded when the game is running headless
+	if (snd == NULL)
+		return;
 	Mix_PlayChannel(-1, snd, 0);
 }
 
 // Play music
 void snd_play_mus(Mix_Music *mus)
 {
+	if (mus == NULL)
+		return;
 	Mix_PlayMusic(mus, -1);
         snd_mus_current = mus;
 }
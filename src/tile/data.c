@@ -71,8 +71,11 @@ static const TileMetadata g_tile_metadata[TILE_MAX] = {
 // Constant pointer to the first index of tile_property_list
 const TileMetadata *const g_tile_md = g_tile_metadata;
 
-// 2d array containing TileId objects
-TileId **g_tile_map = NULL;
+// Map memory containing tile ids
+MapGrid g_tile_map = {.chunk = NULL};
+
+// Revision of g_tile_map, increased whenever its tiles change
+unsigned int g_tile_map_rev = 0;
 
 // Tile type for tiles outside the map
 TileId g_tile_outside = TILE_LIME;
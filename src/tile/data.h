@@ -7,6 +7,8 @@
 
 #include <SDL2/SDL.h>
 
+#include "../map.h"	// For MapGrid
+
 // Tile types (NOTE: the order that these are declared is important because these values are used to index the types of tiles in arrays)
 typedef enum{
 	TILE_AIR,
@@ -69,8 +71,11 @@ typedef struct{
 // Constant pointer to the first index of tile_property_list (defined in tile/data.c)
 extern const TileMetadata *const g_tile_md;
 
-// Pointer to map memory (term defined in map.h) containing tile ids
-extern TileId **g_tile_map;
+// Map memory (term defined in map.h) containing tile ids
+extern MapGrid g_tile_map;
+
+// Revision of g_tile_map, increased whenever its tiles change (see tile/plane.h)
+extern unsigned int g_tile_map_rev;
 
 // Id of tile type to treat all tiles outside the map as
 extern TileId g_tile_outside;
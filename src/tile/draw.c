@@ -26,7 +26,7 @@ void tile_draw_all()
 	{
 		for (int x = tile_left; x < tile_right; ++x)
 		{
-			TileId ti = g_tile_map[y][x];
+			TileId ti = map_grid_get(&g_tile_map, x, y);
 
 			// Don't draw air
 			switch (ti)
@@ -0,0 +1,192 @@
+/*
+ * plane.c contains tile flag bitplanes.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "../error.h"
+#include "../map.h"
+#include "../util/math.h"	// For MIN
+#include "data.h"
+#include "plane.h"
+
+// # of tiles in a bitplane word
+#define	TILE_PLANE_WORD_BITS	64
+
+// Flag of each bitplane
+static const TileFlags g_tile_plane_flag[TILE_PLANE_MAX] = {
+	[TILE_PLANE_SOLID] = TFLAG_SOLID,
+	[TILE_PLANE_SPIKE] = TFLAG_SPIKE,
+	[TILE_PLANE_EVILSTOP] = TFLAG_EVILSTOP,
+};
+
+// Bitplanes, one bit per tile
+static uint64_t *g_tile_plane[TILE_PLANE_MAX];
+
+// # of words in a row of a bitplane
+static int g_tile_plane_stride = 0;
+
+// # of rows in the bitplanes
+static int g_tile_plane_height = 0;
+
+// Returns a word with the bits of columns tx1 to tx2 in a word set, where both are indexes of bits in the word
+static inline uint64_t tile_plane_mask(int tx1, int tx2);
+
+// Builds the bitplanes of the current map from g_tile_map, returns nonzero on error
+int tile_plane_build(void)
+{
+	const int stride = (g_map.width + TILE_PLANE_WORD_BITS - 1) / TILE_PLANE_WORD_BITS;
+	const size_t len = (size_t) stride * g_map.height;
+	for (int i = 0; i < TILE_PLANE_MAX; i++)
+	{
+		free(g_tile_plane[i]);
+		if ((g_tile_plane[i] = calloc(len == 0 ? 1 : len, sizeof(uint64_t))) == NULL)
+		{
+			PERR("failed to allocate mem for tile bitplanes");
+			tile_plane_free();
+			return 1;
+		}
+	}
+	g_tile_plane_stride = stride;
+	g_tile_plane_height = g_map.height;
+	g_tile_map_rev++;
+
+	// Bitplanes each tile id is in, one bit per bitplane
+	uint8_t planes_of[TILE_MAX];
+	for (int ti = 0; ti < TILE_MAX; ti++)
+	{
+		planes_of[ti] = 0;
+		for (int i = 0; i < TILE_PLANE_MAX; i++)
+			if (g_tile_md[ti].flags & g_tile_plane_flag[i])
+				planes_of[ti] |= 1 << i;
+	}
+
+	// Shared chunks can be skipped when the empty tile isn't in any bitplane
+	const bool skip_shared = planes_of[g_tile_map.empty] == 0;
+
+	// Build each word of every bitplane at once
+	for (int y = 0; y < g_map.height; y++)
+	{
+		for (int x1 = 0; x1 < g_map.width; x1 += TILE_PLANE_WORD_BITS)
+		{
+			uint64_t word[TILE_PLANE_MAX] = {0};
+			const int x2 = MIN(x1 + TILE_PLANE_WORD_BITS, g_map.width);
+
+			// Go through the word one chunk row at a time
+			for (int cx = x1; cx < x2; cx += MAP_CHUNK_SIZE)
+			{
+				const MapChunk *c = MAP_GRID_CHUNK(&g_tile_map, cx, y);
+				if (skip_shared && c == g_tile_map.shared)
+					continue;
+
+				const MapCell *row = &c->cell[MAP_CHUNK_INDEX(0, y)];
+				const int len = MIN(MAP_CHUNK_SIZE, x2 - cx);
+				for (int i = 0; i < len; i++)
+				{
+					const unsigned int planes = planes_of[row[i]];
+					for (int p = 0; p < TILE_PLANE_MAX; p++)
+						word[p] |= (uint64_t) (planes >> p & 1) << (cx - x1 + i);
+				}
+			}
+
+			const size_t index = (size_t) y * stride + x1 / TILE_PLANE_WORD_BITS;
+			for (int i = 0; i < TILE_PLANE_MAX; i++)
+				g_tile_plane[i][index] = word[i];
+		}
+	}
+	return 0;
+}
+
+// Frees the bitplanes
+void tile_plane_free(void)
+{
+	for (int i = 0; i < TILE_PLANE_MAX; i++)
+	{
+		free(g_tile_plane[i]);
+		g_tile_plane[i] = NULL;
+	}
+	g_tile_plane_stride = 0;
+	g_tile_plane_height = 0;
+}
+
+// Returns the bitplane of a single tile flag, or -1 if flags isn't exactly one flag that has a bitplane
+int tile_plane_of(TileFlags flags)
+{
+	for (int i = 0; i < TILE_PLANE_MAX; i++)
+		if (flags == g_tile_plane_flag[i])
+			return i;
+	return -1;
+}
+
+// Returns true if the tile at (tx, ty) in the map has its bit set in a bitplane
+bool tile_plane_get(TilePlane plane, int tx, int ty)
+{
+	return (g_tile_plane[plane][(size_t) ty * g_tile_plane_stride + tx / TILE_PLANE_WORD_BITS] >> (tx % TILE_PLANE_WORD_BITS)) & 1;
+}
+
+// Finds the first tile with its bit set in a bitplane from column tx1 to column tx2 (in either direction) in row ty
+// Both columns must be in the map
+// Returns the column of the tile, or TILE_PLANE_NONE if there isn't one
+int tile_plane_find(TilePlane plane, int ty, int tx1, int tx2)
+{
+	const uint64_t *row = g_tile_plane[plane] + (size_t) ty * g_tile_plane_stride;
+	if (tx1 <= tx2)
+	{
+		// Check words from left to right, the lowest set bit is the leftmost tile
+		for (int w = tx1 / TILE_PLANE_WORD_BITS; w <= tx2 / TILE_PLANE_WORD_BITS; w++)
+		{
+			const int base = w * TILE_PLANE_WORD_BITS;
+			const uint64_t bits = row[w] & tile_plane_mask(tx1 > base ? tx1 - base : 0, tx2 < base + TILE_PLANE_WORD_BITS - 1 ? tx2 - base : TILE_PLANE_WORD_BITS - 1);
+			if (bits != 0)
+				return base + __builtin_ctzll(bits);
+		}
+	}
+	else
+	{
+		// Check words from right to left, the highest set bit is the rightmost tile
+		for (int w = tx1 / TILE_PLANE_WORD_BITS; w >= tx2 / TILE_PLANE_WORD_BITS; w--)
+		{
+			const int base = w * TILE_PLANE_WORD_BITS;
+			const uint64_t bits = row[w] & tile_plane_mask(tx2 > base ? tx2 - base : 0, tx1 < base + TILE_PLANE_WORD_BITS - 1 ? tx1 - base : TILE_PLANE_WORD_BITS - 1);
+			if (bits != 0)
+				return base + TILE_PLANE_WORD_BITS - 1 - __builtin_clzll(bits);
+		}
+	}
+	return TILE_PLANE_NONE;
+}
+
+// Sets the tile at (tx, ty) in the map and updates the bitplanes
+void tile_set(int tx, int ty, TileId id)
+{
+	if (map_grid_set(&g_tile_map, tx, ty, id))
+		return;
+	g_tile_map_rev++;
+	if (ty >= g_tile_plane_height)
+		return;
+
+	const TileFlags flags = g_tile_md[id].flags;
+	const uint64_t bit = (uint64_t) 1 << (tx % TILE_PLANE_WORD_BITS);
+	const size_t word = (size_t) ty * g_tile_plane_stride + tx / TILE_PLANE_WORD_BITS;
+	for (int i = 0; i < TILE_PLANE_MAX; i++)
+	{
+		if (flags & g_tile_plane_flag[i])
+			g_tile_plane[i][word] |= bit;
+		else
+			g_tile_plane[i][word] &= ~bit;
+	}
+}
+
+// Returns the # of bytes allocated for the bitplanes
+size_t tile_plane_mem_size(void)
+{
+	return (size_t) TILE_PLANE_MAX * g_tile_plane_stride * g_tile_plane_height * sizeof(uint64_t);
+}
+
+// Returns a word with the bits of columns tx1 to tx2 in a word set, where both are indexes of bits in the word
+static inline uint64_t tile_plane_mask(int tx1, int tx2)
+{
+	return (~(uint64_t) 0 >> (TILE_PLANE_WORD_BITS - 1 - tx2)) & (~(uint64_t) 0 << tx1);
+}
@@ -0,0 +1,54 @@
+/*
+ * plane.h contains tile flag bitplanes, which store one bit per tile in the map for each tile flag that collisions check for.
+ *
+ * Collision checks would otherwise have to read each tile's id from g_tile_map and then its flags from g_tile_md. Bitplanes answer the same question from one bit, and a 64-bit word holds 64 tiles of a row, so a whole span of a row is checked with a few word operations. Rows of a plane are stored one after another, each padded to a whole # of words.
+ *
+ * Bitplanes are built from g_tile_map when a map is loaded or resized. Tiles changed after that must be set with tile_set(), which keeps the bitplanes up to date. Both increase g_tile_map_rev, so things that cache what they found in the tile map know when to look again.
+ */
+
+#ifndef	TILE_PLANE_H
+#define	TILE_PLANE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "data.h"
+
+// Tile flags that have bitplanes
+typedef enum{
+	TILE_PLANE_SOLID,
+	TILE_PLANE_SPIKE,
+	TILE_PLANE_EVILSTOP,
+
+	// Total number of bitplanes (must be listed last)
+	TILE_PLANE_MAX,
+} TilePlane;
+
+// Returned by tile_plane_find() when no tile is found
+#define	TILE_PLANE_NONE	-1
+
+// Builds the bitplanes of the current map from g_tile_map, returns nonzero on error
+int tile_plane_build(void);
+
+// Frees the bitplanes
+void tile_plane_free(void);
+
+// Returns the bitplane of a single tile flag, or -1 if flags isn't exactly one flag that has a bitplane
+int tile_plane_of(TileFlags flags);
+
+// Returns true if the tile at (tx, ty) in the map has its bit set in a bitplane
+bool tile_plane_get(TilePlane plane, int tx, int ty);
+
+// Finds the first tile with its bit set in a bitplane from column tx1 to column tx2 (in either direction) in row ty
+// Both columns must be in the map
+// Returns the column of the tile, or TILE_PLANE_NONE if there isn't one
+int tile_plane_find(TilePlane plane, int ty, int tx1, int tx2);
+
+// Sets the tile at (tx, ty) in the map and updates the bitplanes
+void tile_set(int tx, int ty, TileId id);
+
+// Returns the # of bytes allocated for the bitplanes
+size_t tile_plane_mem_size(void);
+
+#endif
@@ -1,7 +1,65 @@
 /*
- * timestep.c contains the definition for the game's timestep (approx. milliseconds passed last frame).
+ * timestep.c contains the game's timestep and functions for running the simulation at a fixed tick rate.
  */
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <SDL2/SDL.h>
+
 #include "timestep.h"
 
-double g_ts;
+// The real time in seconds that a tick lasts
+#define	TS_TICK_TIME	(1.0 / TS_TICK_RATE)
+
+_Thread_local double g_ts = 60.0 / TS_TICK_RATE;
+double g_ts_alpha = 1.0;
+
+// Seconds of real time that haven't been simulated yet
+static double g_ts_accumulator = 0.0;
+
+// Performance counter value on the last call to ts_accumulate()
+static uint64_t g_ts_counter_last = 0;
+
+// True if interpolation is stopped until the next tick
+static bool g_ts_lerp_skip = false;
+
+// Empties the tick accumulator, so the time passed before this call isn't simulated
+void ts_reset(void)
+{
+	g_ts_accumulator = 0.0;
+	g_ts_counter_last = SDL_GetPerformanceCounter();
+}
+
+// Adds the real time passed since the last call to the tick accumulator
+void ts_accumulate(void)
+{
+	const uint64_t counter = SDL_GetPerformanceCounter();
+	double frame_time = (double) (counter - g_ts_counter_last) / SDL_GetPerformanceFrequency();
+	g_ts_counter_last = counter;
+
+	if (frame_time > TS_FRAME_TIME_MAX)
+		frame_time = TS_FRAME_TIME_MAX;
+	g_ts_accumulator += frame_time;
+}
+
+// Returns true and takes one tick's worth of time from the accumulator if there's enough time in it to simulate another tick
+// When this returns false, g_ts_alpha is set for drawing the current frame
+bool ts_tick(void)
+{
+	if (g_ts_accumulator >= TS_TICK_TIME)
+	{
+		g_ts_accumulator -= TS_TICK_TIME;
+		g_ts_lerp_skip = false;
+		return true;
+	}
+	g_ts_alpha = g_ts_lerp_skip ? 1.0 : g_ts_accumulator / TS_TICK_TIME;
+	return false;
+}
+
+// Stops interpolation until the next tick
+// This should be called when something teleports, so that it isn't drawn between its old and new positions
+void ts_skip_lerp(void)
+{
+	g_ts_lerp_skip = true;
+}
@@ -1,10 +1,46 @@
 /*
- * timestep.h contains the extern declaration for the game's timestep (approx. milliseconds passed last frame).
+ * timestep.h contains the game's timestep and functions for running the simulation at a fixed tick rate.
+ *
+ * The game world is updated in simulation ticks that happen TS_TICK_RATE times per second, no matter how often frames are rendered. Every rendered frame adds the real time passed since the last frame to an accumulator, and a tick is simulated for each tick's worth of time in it. The time left over in the accumulator is used to interpolate what's drawn between the previous and current ticks, so motion stays smooth on displays with refresh rates that don't match the tick rate.
  */
 
 #ifndef	TIMESTEP_H
 #define	TIMESTEP_H
 
-extern double g_ts;
+#include <stdbool.h>
+
+// Simulation ticks per second
+#define	TS_TICK_RATE	60
+
+// Max # of seconds of real time that can be added to the accumulator in one frame
+// This stops a long hitch from causing a burst of ticks that takes even longer to simulate
+#define	TS_FRAME_TIME_MAX	0.25
+
+// Returns a value interpolated between its value on the previous tick (prev) and on the current tick (cur) for drawing
+#define	TS_LERP(prev, cur)	((prev) + ((cur) - (prev)) * g_ts_alpha)
+
+// Returns a position interpolated for drawing between the previous and current ticks for something moving spd pixels per tick in a straight line
+#define	TS_LERP_SPD(cur, spd)	((cur) - (spd) * g_ts * (1.0 - g_ts_alpha))
+
+// The game's timestep (# of 60 Hz frames that pass every tick)
+// Each thread has its own copy, so entities updated in jobs can be given their own timesteps (see job.h)
+extern _Thread_local double g_ts;
+
+// How far the current rendered frame is between the previous and current ticks (0 to 1)
+extern double g_ts_alpha;
+
+// Empties the tick accumulator, so the time passed before this call isn't simulated
+void ts_reset(void);
+
+// Adds the real time passed since the last call to the tick accumulator
+void ts_accumulate(void);
+
+// Returns true and takes one tick's worth of time from the accumulator if there's enough time in it to simulate another tick
+// When this returns false, g_ts_alpha is set for drawing the current frame
+bool ts_tick(void);
+
+// Stops interpolation until the next tick
+// This should be called when something teleports, so that it isn't drawn between its old and new positions
+void ts_skip_lerp(void);
 
 #endif
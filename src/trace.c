@@ -0,0 +1,130 @@
+/*
+ * trace.c contains functions for recording timed events and writing them to a file in the Chrome trace format.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <SDL2/SDL.h>
+
+#include "error.h"
+#include "trace.h"
+
+// A begin or end event
+typedef struct{
+	const char *name;
+
+	// Performance counter value when the event happened
+	uint64_t counter;
+
+	// 'B' for begin events and 'E' for end events
+	char phase;
+} TraceEvent;
+
+// Ring buffer of events
+static TraceEvent g_trace_event[TRACE_EVENT_MAX];
+
+// Index in g_trace_event that the next event is stored at
+static int g_trace_event_index = 0;
+
+// True if the ring buffer has been filled at least once, so its oldest event is at g_trace_event_index
+static bool g_trace_wrapped = false;
+
+// Adds an event to the ring buffer
+static void trace_add(const char *name, char phase);
+
+// Records the beginning of an event
+// name must point to a string that lives until the trace is written
+void trace_begin(const char *name)
+{
+	trace_add(name, 'B');
+}
+
+// Records the end of an event
+void trace_end(const char *name)
+{
+	trace_add(name, 'E');
+}
+
+// Records the end of an event and returns value
+int trace_end_int(const char *name, int value)
+{
+	trace_add(name, 'E');
+	return value;
+}
+
+// Writes all events in the ring buffer to TRACE_PATH
+// Returns nonzero on error
+int trace_write(void)
+{
+	// Nothing to write if tracing is disabled or nothing has happened yet
+	if (!g_trace_wrapped && g_trace_event_index == 0)
+		return 0;
+
+	FILE *file;
+	if ((file = fopen(TRACE_PATH, "w")) == NULL)
+	{
+		PERR("failed to open \"%s\" for writing", TRACE_PATH);
+		return 1;
+	}
+
+	const int len = g_trace_wrapped ? TRACE_EVENT_MAX : g_trace_event_index;
+	const int start = g_trace_wrapped ? g_trace_event_index : 0;
+	const double us_per_tick = 1000000.0 / SDL_GetPerformanceFrequency();
+	const uint64_t counter_start = len > 0 ? g_trace_event[start].counter : 0;
+
+	// # of events that have begun and not ended yet
+	// End events whose begin events were overwritten in the ring buffer are skipped
+	int depth = 0;
+
+	// True if an event has been written, so the next one needs a comma before it
+	bool written = false;
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	for (int i = 0; i < len; i++)
+	{
+		const TraceEvent *e = &g_trace_event[(start + i) % TRACE_EVENT_MAX];
+		if (e->phase == 'B')
+		{
+			depth++;
+		}
+		else
+		{
+			if (depth == 0)
+				continue;
+			depth--;
+		}
+		fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":1}",
+			written ? ",\n" : "",
+			e->name,
+			e->phase,
+			(e->counter - counter_start) * us_per_tick
+		);
+		written = true;
+	}
+	fprintf(file, "\n]}\n");
+
+	if (fclose(file) != 0)
+	{
+		PERR("failed to close \"%s\"", TRACE_PATH);
+		return 1;
+	}
+	PINF("wrote %d trace events to \"%s\"", len, TRACE_PATH);
+	return 0;
+}
+
+// Adds an event to the ring buffer
+static void trace_add(const char *name, char phase)
+{
+	g_trace_event[g_trace_event_index] = (TraceEvent) {
+		.name = name,
+		.counter = SDL_GetPerformanceCounter(),
+		.phase = phase,
+	};
+	if (++g_trace_event_index == TRACE_EVENT_MAX)
+	{
+		g_trace_event_index = 0;
+		g_trace_wrapped = true;
+	}
+}
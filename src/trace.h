@@ -0,0 +1,47 @@
+/*
+ * trace.h contains functions for recording timed events and writing them to a file in the Chrome trace format.
+ *
+ * Begin and end events are recorded into a ring buffer that holds the last TRACE_EVENT_MAX events. The buffer is written to TRACE_PATH when the game exits or when F5 is pressed in game. The file can be opened with chrome://tracing or https://ui.perfetto.dev to see a timeline of where time was spent.
+ *
+ * Stages timed by the frame profiler (see prof.h) are recorded automatically. Other code can be traced with TRACE(), which wraps the statement after it like a loop:
+ * 	TRACE ("something slow")
+ * 		something_slow();
+ * or with TRACE_INT() for calls that return an int or enum:
+ * 	if (TRACE_INT("map_load", map_load(path, false)))
+ */
+
+#ifndef	TRACE_H
+#define	TRACE_H
+
+// If defined, trace events are recorded
+#define	TRACE_ENABLED
+
+// Max # of events held in the ring buffer
+#define	TRACE_EVENT_MAX	65536
+
+// Path of the file that trace events are written to
+#define	TRACE_PATH	"trace.json"
+
+#ifdef	TRACE_ENABLED
+	#define	TRACE(name)		for (int trace_once_ = (trace_begin(name), 1); trace_once_; trace_once_ = (trace_end(name), 0))
+	#define	TRACE_INT(name, call)	(trace_begin(name), trace_end_int(name, (call)))
+#else
+	#define	TRACE(name)		if (0) {} else
+	#define	TRACE_INT(name, call)	(call)
+#endif
+
+// Records the beginning of an event
+// name must point to a string that lives until the trace is written
+void trace_begin(const char *name);
+
+// Records the end of an event
+void trace_end(const char *name);
+
+// Records the end of an event and returns value
+int trace_end_int(const char *name, int value);
+
+// Writes all events in the ring buffer to TRACE_PATH
+// Returns nonzero on error
+int trace_write(void);
+
+#endif
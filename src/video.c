@@ -29,9 +29,6 @@ bool g_vsync = true;
 // Display refresh rate of window if vsync is disabled
 int g_no_vsync_refresh_rate = CONSTEXPR_G_NO_VSYNC_REFRESH_RATE;
 
-// The number of SDL ticks a frame should last if vsync is disabled
-unsigned int g_no_vsync_frame_ticks = 1000.0 / CONSTEXPR_G_NO_VSYNC_REFRESH_RATE;
-
 // Scales SDL's renderer and updates screen dimensions
 void screen_scale(float xscale, float yscale)
 {
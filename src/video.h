@@ -27,9 +27,6 @@ extern bool g_vsync;
 // Display refresh rate of window if vsync is disabled
 extern int g_no_vsync_refresh_rate;
 
-// The number of SDL ticks a frame should last if vsync is disabled
-extern unsigned int g_no_vsync_frame_ticks;
-
 // Scales SDL's renderer and updates screen dimensions
 void screen_scale(float xscale, float yscale);
 